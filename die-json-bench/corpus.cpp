@@ -0,0 +1,215 @@
+#include "corpus.h"
+#include "../die-json.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace bench {
+
+namespace {
+
+// without exceptions the bench just ends
+[[noreturn]] void fail(std::string const & what)
+{
+#ifdef DIE_JSON_EXCEPTIONS
+	throw std::runtime_error(what);
+#else
+	std::fprintf(stderr,"%s\n",what.c_str());
+	std::exit(1);
+#endif
+}
+
+// same sequence on every platform
+class Random {
+	std::uint64_t state = 0x9E3779B97F4A7C15ull;
+public:
+	std::uint64_t next()
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+	int below(int limit) { return int(next() % unsigned(limit)); }
+	double real() { return double(next() >> 11) / double(1ull << 53); }
+};
+
+std::string text(Random & random, int size, bool escapes)
+{
+	static char const plain[] = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ 0123456789";
+	static char const * const special[] = { "\"", "\\", "\n", "\t", "/", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\x01" };
+	std::string str;
+	for( int i = 0; i < size; ++i ) {
+		if( escapes && random.below(4) == 0 ) {
+			str += special[random.below(sizeof(special) / sizeof(special[0]))];
+		} else {
+			str += plain[random.below(sizeof(plain) - 1)];
+		}
+	}
+	return str;
+}
+
+// one record of a typical API payload
+void record(die::json::Writer & writer, Random & random, int id)
+{
+	writer.onStartObject("");
+	writer.onNumber("id",id);
+	writer.onString("name",text(random,12,false));
+	writer.onString("email",text(random,8,false) + "@example.com");
+	writer.onBool("active",random.below(2) == 0);
+	writer.onNumber("score",random.real() * 100);
+	writer.onStartArray("tags");
+	for( int i = random.below(4); i >= 0; --i ) {
+		writer.onString("",text(random,6,false));
+	}
+	writer.onEndArray("tags");
+	writer.onStartObject("address");
+	writer.onString("city",text(random,10,false));
+	writer.onNumber("zip",random.below(100000));
+	writer.onNull("unit");
+	writer.onEndObject("address");
+	writer.onEndObject("");
+}
+
+std::string records(Random & random, int count, int indent)
+{
+	die::json::Writer writer;
+	writer.indent(indent);
+	writer.onStartArray("");
+	for( int i = 0; i < count; ++i ) {
+		record(writer,random,i);
+	}
+	writer.onEndArray("");
+	return std::string(writer.text());
+}
+
+// one record per line
+std::string lines(Random & random, int count)
+{
+	std::string text;
+	for( int i = 0; i < count; ++i ) {
+		die::json::Writer writer;
+		record(writer,random,i);
+		text.append(writer.text()).push_back('\n');
+	}
+	return text;
+}
+
+std::string numbers(Random & random, int count)
+{
+	die::json::Writer writer;
+	writer.onStartObject("");
+	writer.onStartArray("points");
+	for( int i = 0; i < count; ++i ) {
+		writer.onStartArray("");
+		writer.onNumber("",random.real() * 360 - 180);
+		writer.onNumber("",random.real() * 180 - 90);
+		writer.onNumber("",std::int64_t(random.next() >> 20) - (std::int64_t(1) << 43));
+		writer.onNumber("",random.below(1000));
+		writer.onEndArray("");
+	}
+	writer.onEndArray("points");
+	writer.onEndObject("");
+	return std::string(writer.text());
+}
+
+std::string strings(Random & random, int count, bool escapes)
+{
+	die::json::Writer writer;
+	writer.onStartArray("");
+	for( int i = 0; i < count; ++i ) {
+		writer.onStartObject("");
+		writer.onString("title",text(random,40,escapes));
+		writer.onString("body",text(random,400,escapes));
+		writer.onEndObject("");
+	}
+	writer.onEndArray("");
+	return std::string(writer.text());
+}
+
+// many subtrees of objects and arrays in turn, deep down to depth
+std::string nested(Random & random, int count, int depth)
+{
+	die::json::Writer writer;
+	writer.onStartArray("");
+	for( int i = 0; i < count; ++i ) {
+		for( int level = 0; level < depth; ++level ) {
+			if( level % 2 ) {
+				writer.onStartArray("a");
+			} else {
+				writer.onStartObject("");
+				writer.onNumber("level",level);
+			}
+		}
+		writer.onString("leaf",text(random,8,false));
+		for( int level = depth - 1; level >= 0; --level ) {
+			if( level % 2 ) {
+				writer.onEndArray("a");
+			} else {
+				writer.onEndObject("");
+			}
+		}
+	}
+	writer.onEndArray("");
+	return std::string(writer.text());
+}
+
+Dataset dataset(std::string name, std::vector<std::string> docs, bool lines = false)
+{
+	Dataset data;
+	data.name = std::move(name);
+	data.docs = std::move(docs);
+	data.lines = lines;
+	die::json::BasicParser<Counter> counter;
+	counter.throwErrors(false);
+	for( auto const & doc : data.docs ) {
+		data.bytes += doc.size();
+		if( ! (lines ? counter.parseLines(doc) : counter.parse(doc)) ) fail("invalid document in " + data.name + ": " + counter.error().message());
+	}
+	data.events = counter.getHandler().events;
+	return data;
+}
+
+} /* anonymous namespace */
+
+std::vector<Dataset> generate(double scale)
+{
+	auto count = [scale](int full) { return std::max(1,int(full * scale)); };
+	Random random;
+	std::vector<Dataset> corpus;
+	corpus.push_back(dataset("numbers",{numbers(random,count(100000))}));
+	corpus.push_back(dataset("strings",{strings(random,count(8000),false)}));
+	corpus.push_back(dataset("escapes",{strings(random,count(8000),true)}));
+	corpus.push_back(dataset("nested",{nested(random,count(200),400)}));
+	// both start from a fresh sequence, so they hold the same records and only the layout differs
+	auto layout = [&count](int indent) {
+		Random fresh;
+		return records(fresh,count(20000),indent);
+	};
+	corpus.push_back(dataset("minified",{layout(0)}));
+	corpus.push_back(dataset("pretty",{layout(2)}));
+	std::vector<std::string> small;
+	for( int i = count(20000); i > 0; --i ) {
+		small.push_back(records(random,1,0));
+	}
+	corpus.push_back(dataset("small docs",std::move(small)));
+	corpus.push_back(dataset("huge doc",{records(random,count(200000),0)}));
+	corpus.push_back(dataset("json lines",{lines(random,count(200000))},true));
+	return corpus;
+}
+
+Dataset load(std::string const & path)
+{
+	std::ifstream file(path,std::ios::binary);
+	if( ! file ) fail("cannot read " + path);
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	auto name = path.substr(path.find_last_of("/\\") + 1);
+	return dataset(name,{contents.str()});
+}
+
+} /* namespace bench */
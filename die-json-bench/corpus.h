@@ -0,0 +1,40 @@
+#ifndef CORPUS_H_DIE_JSON_BENCH_2026_10_17
+#define CORPUS_H_DIE_JSON_BENCH_2026_10_17
+
+#include <string>
+#include <vector>
+#include "../die-json.h"
+
+namespace bench {
+
+// counts every event, for the reference parse and the cases that count them
+struct Counter: die::json::BaseHandler {
+	std::size_t events = 0;
+	void onStartObject(std::string_view) { ++events; }
+	void onEndObject(std::string_view) { ++events; }
+	void onStartArray(std::string_view) { ++events; }
+	void onEndArray(std::string_view) { ++events; }
+	void onString(std::string_view, std::string_view) { ++events; }
+	void onNumber(std::string_view, std::string_view) { ++events; }
+	void onBool(std::string_view, bool) { ++events; }
+	void onNull(std::string_view) { ++events; }
+};
+
+// a set of documents parsed as one benchmark case
+struct Dataset {
+	std::string name;
+	std::vector<std::string> docs;
+	std::size_t bytes = 0;
+	std::size_t events = 0;	// over all the docs, counted by a reference parse
+	bool lines = false;	// the docs are JSON Lines, for the engines that parse them
+};
+
+// the generated corpus. scale multiplies the sizes; the contents only depend on it
+std::vector<Dataset> generate(double scale);
+
+// a json file as a dataset of its own
+Dataset load(std::string const & path);
+
+} /* namespace bench */
+
+#endif /* CORPUS_H_ */
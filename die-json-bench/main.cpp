@@ -0,0 +1,290 @@
+// throughput of the parsing interfaces over a generated corpus
+// usage: die-json-bench [--quick] [--time seconds] [--only engine] [file.json ...]
+// files given are benchmarked after the generated datasets
+
+#include "../die-json.h"
+#include "corpus.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+	std::atomic<std::size_t> allocations{0};
+}
+
+// every allocation of the process is counted. the whole set is replaced, so each delete matches its new
+namespace {
+	void * allocate(std::size_t size, std::size_t alignment = 0)
+	{
+		++allocations;
+		if( ! size ) size = 1;
+		if( alignment > alignof(std::max_align_t) ) {
+			// aligned_alloc wants a multiple of the alignment
+			return std::aligned_alloc(alignment,(size + alignment - 1) / alignment * alignment);
+		}
+		return std::malloc(size);
+	}
+
+	void * allocateOrThrow(std::size_t size, std::size_t alignment = 0)
+	{
+		if( void * p = allocate(size,alignment) ) return p;
+#ifdef DIE_JSON_EXCEPTIONS
+		throw std::bad_alloc();
+#else
+		std::abort();
+#endif
+	}
+}
+
+void * operator new(std::size_t size) { return allocateOrThrow(size); }
+void * operator new[](std::size_t size) { return allocateOrThrow(size); }
+void * operator new(std::size_t size, std::align_val_t al) { return allocateOrThrow(size,std::size_t(al)); }
+void * operator new[](std::size_t size, std::align_val_t al) { return allocateOrThrow(size,std::size_t(al)); }
+void * operator new(std::size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+void * operator new[](std::size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+void * operator new(std::size_t size, std::align_val_t al, std::nothrow_t const &) noexcept { return allocate(size,std::size_t(al)); }
+void * operator new[](std::size_t size, std::align_val_t al, std::nothrow_t const &) noexcept { return allocate(size,std::size_t(al)); }
+
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete[](void * p) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void * p, std::size_t) noexcept { std::free(p); }
+void operator delete(void * p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void * p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void * p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void * p, std::nothrow_t const &) noexcept { std::free(p); }
+void operator delete[](void * p, std::nothrow_t const &) noexcept { std::free(p); }
+void operator delete(void * p, std::align_val_t, std::nothrow_t const &) noexcept { std::free(p); }
+void operator delete[](void * p, std::align_val_t, std::nothrow_t const &) noexcept { std::free(p); }
+
+namespace {
+
+// parses all the docs of a dataset and returns the events seen, which have to be the ones of the reference parse
+using Run = std::function<std::size_t(bench::Dataset const &)>;
+
+struct Engine {
+	char const * name;
+	Run run;
+	bool lines = false;	// runs on the JSON Lines datasets instead of the others
+};
+
+void fail(bench::Dataset const & data, char const * engine, die::json::Error const & error)
+{
+	std::fprintf(stderr,"%s failed on %s: %s\n",engine,data.name.c_str(),error.message().c_str());
+	std::exit(1);
+}
+
+// the events the parse of a Document went through: one per value and two per object or array
+std::size_t countEvents(die::json::Document::Value value)
+{
+	using Type = die::json::Document::Type;
+	if( value.type() != Type::object && value.type() != Type::array ) return 1;
+	std::size_t events = 2;
+	for( auto element : value ) {
+		events += countEvents(element);
+	}
+	return events;
+}
+
+std::size_t parseAll(die::json::Parser & parser, bench::Dataset const & data, std::size_t & events)
+{
+	for( auto const & doc : data.docs ) {
+		if( ! parser.parse(doc) ) fail(data,"Parser",parser.error());
+	}
+	return events;
+}
+
+template<die::json::Engine engineType>
+std::size_t basic(bench::Dataset const & data)
+{
+	die::json::BasicParser<bench::Counter> parser;
+	parser.engine(engineType).throwErrors(false);
+	for( auto const & doc : data.docs ) {
+		if( ! parser.parse(doc) ) fail(data,"BasicParser",parser.error());
+	}
+	return parser.getHandler().events;
+}
+
+// the root arrays have no events in ParallelParser
+std::size_t rootArrays(bench::Dataset const & data)
+{
+	std::size_t count = 0;
+	for( auto const & doc : data.docs ) {
+		auto first = doc.find_first_not_of(" \t\r\n");
+		if( first != doc.npos && doc[first] == '[' ) {
+			++count;
+		}
+	}
+	return count;
+}
+
+// the parallel cases take the pieces a bit smaller than the default, so the generated docs are spread over the workers
+std::size_t const pieceSize = 256 * 1024;
+
+std::size_t parallel(bench::Dataset const & data)
+{
+	die::json::ParallelParser<bench::Counter> parser;
+	parser.pieceSize(pieceSize).throwErrors(false);
+	for( auto const & doc : data.docs ) {
+		if( ! (data.lines ? parser.parseLines(doc) : parser.parse(doc)) ) fail(data,"ParallelParser",parser.error());
+	}
+	std::size_t events = 0;
+	for( unsigned worker = 0; worker < parser.workers(); ++worker ) {
+		events += parser.getHandler(worker).events;
+	}
+	return data.lines ? events : events + rootArrays(data) * 2;
+}
+
+std::size_t parallelOrdered(bench::Dataset const & data)
+{
+	die::json::ParallelParser<bench::Counter> parser;
+	parser.pieceSize(pieceSize).throwErrors(false);
+	bench::Counter counter;
+	for( auto const & doc : data.docs ) {
+		auto parsed = data.lines ? parser.parseLinesOrdered(doc,counter) : parser.parseOrdered(doc,counter);
+		if( ! parsed ) fail(data,"ParallelParser",parser.error());
+	}
+	return data.lines ? counter.events : counter.events + rootArrays(data) * 2;
+}
+
+std::vector<Engine> engines()
+{
+	return {
+		{"Parser", [](bench::Dataset const & data) {
+			std::size_t events = 0;
+			die::json::Parser parser;
+			auto count = [&events](auto &&...) { ++events; };
+			parser.startObjectView(count).endObjectView(count).startArrayView(count).endArrayView(count).valueView(count);
+			parser.throwErrors(false);
+			return parseAll(parser,data,events);
+		}},
+		{"BasicParser table", basic<die::json::Engine::automaton>},
+		{"BasicParser switched", basic<die::json::Engine::switched>},
+		{"BasicParser indexed", basic<die::json::Engine::indexed>},
+		{"Reader", [](bench::Dataset const & data) {
+			std::size_t events = 0;
+			die::json::Reader reader;
+			reader.throwErrors(false);
+			for( auto const & doc : data.docs ) {
+				reader.reset(doc);
+				while( reader.next().kind != die::json::Reader::Kind::end ) {
+					++events;
+				}
+				if( reader.error() ) fail(data,"Reader",reader.error());
+			}
+			return events;
+		}},
+		// the walk that counts the events is timed along with the parse
+		{"Document", [](bench::Dataset const & data) {
+			std::size_t events = 0;
+			die::json::Document document;
+			document.throwErrors(false);
+			for( auto const & doc : data.docs ) {
+				if( ! document.parse(doc) ) fail(data,"Document",document.error());
+				events += countEvents(document.root());
+			}
+			return events;
+		}},
+		{"ParallelParser", parallel},
+		{"ParallelParser ordered", parallelOrdered},
+		{"BasicParser lines", [](bench::Dataset const & data) {
+			die::json::BasicParser<bench::Counter> parser;
+			parser.throwErrors(false);
+			for( auto const & doc : data.docs ) {
+				if( ! parser.parseLines(doc) ) fail(data,"BasicParser",parser.error());
+			}
+			return parser.getHandler().events;
+		},true},
+		{"ParallelParser lines", parallel,true},
+		{"ParallelParser lines ordered", parallelOrdered,true},
+	};
+}
+
+struct Result {
+	double seconds;	// of the fastest round
+	double allocations;	// per pass of that round
+};
+
+// rounds of whole passes over the dataset, each long enough to time. the fastest one is kept
+Result measure(Engine const & engine, bench::Dataset const & data, double minTime)
+{
+	using Clock = std::chrono::steady_clock;
+	int const rounds = 5;
+	Result best{1e300,0};
+	for( int round = 0; round < rounds; ++round ) {
+		int passes = 0;
+		auto before = allocations.load();
+		auto start = Clock::now();
+		double elapsed;
+		do {
+			auto events = engine.run(data);
+			if( events != data.events ) {
+				std::fprintf(stderr,"%s saw %zu events on %s instead of %zu\n",engine.name,events,data.name.c_str(),data.events);
+				std::exit(1);
+			}
+			++passes;
+			elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		} while( elapsed < minTime / rounds );
+		auto seconds = elapsed / passes;
+		if( seconds < best.seconds ) {
+			best = Result{seconds,double(allocations.load() - before) / passes};
+		}
+	}
+	return best;
+}
+
+} /* anonymous namespace */
+
+int main(int argc, char ** argv)
+{
+	double scale = 1;
+	double minTime = 1;
+	std::string only;
+	std::vector<std::string> files;
+	for( int i = 1; i < argc; ++i ) {
+		std::string arg = argv[i];
+		if( arg == "--quick" ) {
+			scale = 0.05;
+			minTime = 0.05;
+		} else if( arg == "--time" && i + 1 < argc ) {
+			minTime = std::atof(argv[++i]);
+		} else if( arg == "--only" && i + 1 < argc ) {
+			only = argv[++i];
+		} else if( arg[0] == '-' ) {
+			std::fprintf(stderr,"usage: %s [--quick] [--time seconds] [--only engine] [file.json ...]\n",argv[0]);
+			return 2;
+		} else {
+			files.push_back(arg);
+		}
+	}
+
+	auto corpus = bench::generate(scale);
+	for( auto const & file : files ) {
+		corpus.push_back(bench::load(file));
+	}
+
+	std::printf("%-12s %-28s %10s %12s %12s %12s\n","dataset","engine","MB/s","docs/s","Mevents/s","allocs/doc");
+	for( auto const & data : corpus ) {
+		for( auto const & engine : engines() ) {
+			if( engine.lines != data.lines ) continue;
+			if( ! only.empty() && only != engine.name ) continue;
+			auto result = measure(engine,data,minTime);
+			auto docs = double(data.docs.size());
+			std::printf("%-12s %-28s %10.1f %12.0f %12.2f %12.1f\n",
+				data.name.c_str(),engine.name,
+				data.bytes / result.seconds / 1e6,
+				docs / result.seconds,
+				data.events / result.seconds / 1e6,
+				result.allocations / docs);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,390 @@
+#include <tut.h>
+
+#include "../die-json.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <map>
+
+namespace {
+	// records events in a compact textual form
+	struct RecordingHandler: die::json::BaseHandler {
+		std::string log;
+		void onStartObject(std::string_view name) { log.append("{").append(name).append(";"); }
+		void onEndObject(std::string_view name) { log.append("}").append(name).append(";"); }
+		void onStartArray(std::string_view name) { log.append("[").append(name).append(";"); }
+		void onEndArray(std::string_view name) { log.append("]").append(name).append(";"); }
+		void onString(std::string_view name, std::string_view value) { log.append(name).append("=s:").append(value).append(";"); }
+		void onNumber(std::string_view name, std::string_view value) { log.append(name).append("=n:").append(value).append(";"); }
+		void onBool(std::string_view name, bool value) { log.append(name).append(value ? "=b:1;" : "=b:0;"); }
+		void onNull(std::string_view name) { log.append(name).append("=null;"); }
+	};
+
+	// only cares about numbers
+	struct NumberCounter: die::json::BaseHandler {
+		int count = 0;
+		void onNumber(std::string_view, std::string_view) { ++count; }
+	};
+
+	struct TypedNumbers: die::json::BaseHandler {
+		std::vector<std::int64_t> ints;
+		std::vector<std::uint64_t> uints;
+		std::vector<double> doubles;
+		std::vector<std::string> lexemes;
+		void onInt64(std::string_view, std::int64_t value, std::string_view lexeme) { ints.push_back(value); lexemes.emplace_back(lexeme); }
+		void onUInt64(std::string_view, std::uint64_t value, std::string_view lexeme) { uints.push_back(value); lexemes.emplace_back(lexeme); }
+		void onDouble(std::string_view, double value, std::string_view lexeme) { doubles.push_back(value); lexemes.emplace_back(lexeme); }
+		void onNumber(std::string_view, std::string_view) { tut::fail("onNumber should not be called for typed handlers"); }
+	};
+
+	// records the key id of every value
+	struct KeyIds: die::json::BaseHandler {
+		die::json::BasicParser<KeyIds> const * parser = nullptr;
+		std::vector<int> ids;
+		void onNumber(std::string_view name, std::string_view) { record(name); }
+		void onBool(std::string_view name, bool) { record(name); }
+		void record(std::string_view name)
+		{
+			auto id = parser->currentKeyId();
+			if( id != die::json::KeySet::unknown ) {
+				tut::ensure_equals(parser->keys().key(id), name);
+			}
+			ids.push_back(id);
+		}
+	};
+
+	// slices the input with the span of every event and keeps where the events were
+	struct Slicer: die::json::BaseHandler {
+		die::json::BasicParser<Slicer> const * parser = nullptr;
+		std::string_view input;
+		std::vector<std::string> slices;
+		std::vector<die::json::Position> positions;
+		void onStartObject(std::string_view) { record(); }
+		void onEndObject(std::string_view) { record(); }
+		void onStartArray(std::string_view) { record(); }
+		void onEndArray(std::string_view) { record(); }
+		void onString(std::string_view, std::string_view) { record(); }
+		void onNumber(std::string_view, std::string_view) { record(); }
+		void onBool(std::string_view, bool) { record(); }
+		void onNull(std::string_view) { record(); }
+		void record()
+		{
+			auto span = parser->currentSpan();
+			slices.emplace_back(input.substr(span.offset,span.length));
+			positions.push_back(parser->lastPosition());
+		}
+	};
+
+	// logs names and answers with the control registered for them
+	struct Controller: die::json::BaseHandler {
+		std::map<std::string,die::json::Control,std::less<>> controls;
+		std::string log;
+		die::json::Control react(char kind, std::string_view name)
+		{
+			log.push_back(kind);
+			log.append(name).push_back(';');
+			auto it = controls.find(name);
+			return it == controls.end() ? die::json::Control::proceed : it->second;
+		}
+		die::json::Control onStartObject(std::string_view name) { return react('{',name); }
+		die::json::Control onEndObject(std::string_view name) { return react('}',name); }
+		die::json::Control onStartArray(std::string_view name) { return react('[',name); }
+		die::json::Control onEndArray(std::string_view name) { return react(']',name); }
+		die::json::Control onString(std::string_view name, std::string_view) { return react('s',name); }
+		die::json::Control onNumber(std::string_view name, std::string_view) { return react('n',name); }
+		void onBool(std::string_view name, bool) { react('b',name); }
+	};
+
+	struct setup {
+		die::json::BasicParser<RecordingHandler> parser;
+	};
+}
+
+namespace tut {
+	typedef test_group<setup> tg;
+	tg parser_test_group("JsonBasicParser");
+
+	typedef tg::object testobject;
+
+	template<>
+	template<>
+	void testobject::test<1>()
+	{
+		set_test_name("typed events");
+
+		auto parsed = parser.parse(R"json({ "s" : "v", "a" : [1, true, false, null, {}], "o" : { "x" : -2.5 } })json");
+		ensure("parser did not reach final state", parsed);
+		ensure_equals(parser.getHandler().log,
+			"{;s=s:v;[a;a=n:1;a=b:1;a=b:0;a=null;{a;}a;]a;{o;x=n:-2.5;}o;};");
+	}
+
+	template<>
+	template<>
+	void testobject::test<2>()
+	{
+		set_test_name("partial handler");
+
+		die::json::BasicParser<NumberCounter> counter;
+		std::istringstream iss("{ \"a\" : [1, 2, \"3\"], \"b\" : 4 }");
+		ensure("parser did not reach final state", counter.parse(iss));
+		ensure_equals(counter.getHandler().count, 3);
+	}
+
+	template<>
+	template<>
+	void testobject::test<3>()
+	{
+		set_test_name("typed numbers");
+
+		die::json::BasicParser<TypedNumbers> typed;
+		auto parsed = typed.parse(R"json({ "n" : [
+			0, -0, 42, 1234567890123, -9223372036854775808, 9223372036854775807,
+			9223372036854775808, 18446744073709551615, 18446744073709551616, -9223372036854775809,
+			1.5, -0.25e2, 0.1, 3.141592653589793238462643, 1e400, -4.5E-2878, 77.66e+20
+		] })json");
+		ensure("parser did not reach final state", parsed);
+
+		auto const & h = typed.getHandler();
+		ensure_equals(h.ints.size(), 6);
+		ensure_equals(h.ints[0], 0);
+		ensure_equals(h.ints[1], 0);
+		ensure_equals(h.ints[2], 42);
+		ensure_equals(h.ints[3], 1234567890123);
+		ensure_equals(h.ints[4], INT64_MIN);
+		ensure_equals(h.ints[5], INT64_MAX);
+		ensure_equals(h.uints.size(), 2);
+		ensure_equals(h.uints[0], 9223372036854775808u);
+		ensure_equals(h.uints[1], UINT64_MAX);
+		ensure_equals(h.doubles.size(), 9);
+		ensure_equals(h.doubles[0], 18446744073709551616.0);
+		ensure_equals(h.doubles[1], -9223372036854775809.0);
+		ensure_equals(h.doubles[2], 1.5);
+		ensure_equals(h.doubles[3], -25.0);
+		ensure_equals(h.doubles[4], 0.1);
+		ensure_equals(h.doubles[5], 3.141592653589793238462643);
+		ensure("overflow is infinity", std::isinf(h.doubles[6]) && h.doubles[6] > 0);
+		ensure_equals(h.doubles[7], 0.0);
+		ensure_equals(h.doubles[8], 77.66e+20);
+		ensure_equals(h.lexemes.size(), 17);
+		ensure_equals(h.lexemes[11], "-0.25e2");
+	}
+
+	template<>
+	template<>
+	void testobject::test<4>()
+	{
+		set_test_name("registered keys");
+
+		die::json::KeySet keySet{"id", "user", "count"};
+		ensure_equals(keySet.add("user"), 1);
+		ensure_equals(keySet.find("nope"), die::json::KeySet::unknown);
+		for( int i = 0; i < 100; ++i ) {
+			ensure_equals(keySet.add("k" + std::to_string(i)), 3 + i);
+		}
+		ensure_equals(keySet.find("k42"), 45);
+		ensure_equals(keySet.find("count"), 2);
+
+		die::json::BasicParser<KeyIds> keyParser;
+		keyParser.keys(keySet).getHandler().parser = &keyParser;
+		std::string json = R"json({ "id" : 1, "other" : 2, "user" : { "count" : [3, true], "k7" : 4 }, "\u0069d" : 5 })json";
+		std::istringstream iss(json);
+		ensure("parser did not reach final state", keyParser.parse(iss));
+		ensure_equals(keyParser.getHandler().ids, std::vector<int>{ 0, -1, 2, 2, 10, 0 });
+	}
+
+	template<>
+	template<>
+	void testobject::test<5>()
+	{
+		set_test_name("skip and stop from the events");
+
+		using die::json::Control;
+		die::json::BasicParser<Controller> controlled;
+		auto & handler = controlled.getHandler();
+		std::string json = R"json({ "a" : { "x" : 1, "y" : [2] }, "b" : [3, "s", 4, true], "c" : { "z" : 5 }, "d" : 6, "e" : 7 })json";
+
+		handler.controls = { {"a", Control::skip}, {"b", Control::proceed}, {"z", Control::skip} };
+		ensure("parser did not reach final state", controlled.parse(json));
+		ensure_equals(handler.log, "{;{a;[b;nb;sb;nb;bb;]b;{c;nz;nd;ne;};");
+		ensure_not(controlled.stopped());
+
+		// a skip from the last number of an object is done when the object ends
+		handler.log.clear();
+		handler.controls = { {"y", Control::skip}, {"x", Control::skip} };
+		ensure("parser did not reach final state", controlled.parse(R"json({ "o" : { "x" : 1 }, "y" : 2, "z" : 3 })json"));
+		ensure_equals(handler.log, "{;{o;nx;ny;");
+
+		handler.log.clear();
+		handler.controls = { {"d", Control::stop} };
+		ensure_not("stopped parse should return false", controlled.parse(json));
+		ensure("parser should report the stop", controlled.stopped());
+		ensure_equals(controlled.stopOffset(), json.find("6") + 2);
+		ensure_equals(handler.log, "{;{a;nx;[y;ny;]y;}a;[b;nb;sb;nb;bb;]b;{c;nz;}c;nd;");
+
+		handler.log.clear();
+		for( std::size_t i = 0; i < json.size(); i += 5 ) {
+			if( ! controlled.feed(std::string_view(json).substr(i,5)) ) break;
+		}
+		ensure("parser should report the stop", controlled.stopped());
+		ensure_equals(controlled.stopOffset(), json.find("6") + 2);
+		ensure_equals(handler.log, "{;{a;nx;[y;ny;]y;}a;[b;nb;sb;nb;bb;]b;{c;nz;}c;nd;");
+		ensure_not(controlled.finish());
+
+		// std::function callbacks request it instead
+		die::json::Parser parser;
+		int values = 0;
+		parser.value([&](auto name, auto, auto) {
+			++values;
+			if( name == "d" ) parser.request(Control::stop);
+		});
+		ensure_not("stopped parse should return false", parser.parse(json));
+		ensure("parser should report the stop", parser.stopped());
+		ensure_equals(values, 8);
+	}
+
+	template<>
+	template<>
+	void testobject::test<6>()
+	{
+		set_test_name("JSON Lines");
+		std::string lines = "{\"a\":1}\n\n  \t\n{\"b\":[true]}\r\n[2, \"s\"]\n{\"c\":3\n{\"d\":null}";
+		parser.throwErrors(false);
+		ensure_not("the sixth line is incomplete", parser.parseLines(lines));
+		ensure_equals(parser.getHandler().log, "{;a=n:1;};{;[b;b=b:1;]b;};[;=n:2;=s:s;];{;");
+		ensure_equals(parser.error().code, die::json::ErrorCode::incomplete);
+		ensure_equals(parser.error().pos.line, 6);
+		ensure_equals(parser.error().pos.column, 7);
+
+		// the bad line is set aside and the rest is parsed
+		parser.getHandler().log.clear();
+		std::istringstream iss(lines);
+		ensure("isolated lines", parser.throwErrors(true).isolateLines(true).parseLines(iss));
+		ensure_equals(parser.getHandler().log, "{;a=n:1;};{;[b;b=b:1;]b;};[;=n:2;=s:s;];{;{;d=null;};");
+		ensure_equals(parser.badLines().size(), 1u);
+		ensure_equals(parser.badLines()[0].pos.line, 6);
+
+		// a line that leaves its root open is incomplete and the next record does not start inside it
+		parser.getHandler().log.clear();
+		ensure(parser.parseLines("{\"key\":{}\n{\"b\":1}\n"));
+		ensure_equals(parser.getHandler().log, "{;{key;}key;{;b=n:1;};");
+		ensure_equals(parser.badLines().size(), 1u);
+		ensure_equals(parser.badLines()[0].code, die::json::ErrorCode::incomplete);
+		ensure_equals(parser.badLines()[0].pos.line, 1);
+		ensure_equals(parser.badLines()[0].pos.column, 10);
+		die::json::ParallelParser<RecordingHandler> parallel;
+		ensure_not(parallel.threads(2).throwErrors(false).parseLines(std::string("{\"key\":{}\n{\"b\":1}\n")));
+		ensure_equals(parallel.error().code, die::json::ErrorCode::incomplete);
+
+		// a stop ends everything and its offset is in the whole input
+		die::json::BasicParser<Controller> controlled;
+		controlled.getHandler().controls["b"] = die::json::Control::stop;
+		ensure_not(controlled.isolateLines(true).parseLines(lines));
+		ensure("stopped", controlled.stopped());
+		ensure_equals(controlled.stopOffset(), lines.find("[true]") + 1);
+		ensure_equals(controlled.getHandler().log, "{;na;};{;[b;");
+	}
+
+	template<>
+	template<>
+	void testobject::test<7>()
+	{
+		set_test_name("parser stats");
+		std::string doc = R"json({ "a" : [ 1, 22, { "b" : "long value" } ], "c" : true, "d" : null })json";
+		die::json::BasicParser<RecordingHandler> parser;
+		ensure(parser.parse(doc));
+		auto const & stats = parser.stats();
+		using Event = die::json::ParserStats::Event;
+		if( ! die::json::collectStats ) {
+			ensure_equals(stats.bytes, 0u);
+			ensure_equals(stats.eventTotal(), 0u);
+			return;
+		}
+		ensure_equals(stats.bytes, doc.size());
+		ensure_equals(stats.events[std::size_t(Event::startObject)], 2u);
+		ensure_equals(stats.events[std::size_t(Event::number)], 2u);
+		ensure_equals(stats.events[std::size_t(Event::boolean)], 1u);
+		ensure_equals(stats.eventTotal(), 11u);
+		ensure_equals(stats.maxDepth, 3u);
+		ensure_equals(stats.longestValue, 10u);
+		ensure(stats.transitions[std::size_t(die::json::grammar::State::endValue)] > 0);
+		ensure(stats.parserTime.count() > 0);
+
+		// totals add up until cleared
+		ensure(parser.parse(doc));
+		ensure_equals(stats.bytes, 2 * doc.size());
+		parser.stats().clear();
+		ensure_equals(stats.eventTotal(), 0u);
+
+		// escapes make the parser buffer the value
+		ensure(parser.parse(R"json({ "k" : "a\nb" })json"));
+		ensure(stats.allocations <= 1);
+		ensure(parser.parse(std::string("{ \"k\" : \"") + std::string(100,'x') + "\\n\" }"));
+		ensure(stats.allocations >= 1);
+	}
+
+	template<>
+	template<>
+	void testobject::test<8>()
+	{
+		set_test_name("spans and positions");
+		std::string doc = "{\n  \"a\" : [ 1, -2.5e3, \"x\\ny\" ],\n  \"b\" : { \"c\" : true, \"d\" : null }\n}";
+		std::vector<std::string> expected = { "{", "[", "1", "-2.5e3", "\"x\\ny\"", "]", "{", "true", "null", "}", "}" };
+		die::json::BasicParser<Slicer> parser;
+		parser.getHandler().parser = &parser;
+		parser.getHandler().input = doc;
+		ensure(parser.parse(doc));
+		ensure_equals(parser.getHandler().slices, expected);
+		auto const & positions = parser.getHandler().positions;
+		ensure_equals(positions[1].line, 2);
+		ensure_equals(positions[1].column, 9);
+		ensure_equals(positions[3].column, 20); // numbers are completed by the char after them
+		ensure_equals(positions[7].line, 3);
+		ensure_equals(positions[7].column, 20); // keywords by their last letter
+		ensure_equals(parser.lastPosition().line, 4);
+		ensure_equals(parser.lastPosition().column, 2);
+
+		// offsets count from the start of the document in every mode
+		for( std::size_t chunkSize : { 1, 3, 64 } ) {
+			parser.getHandler().slices.clear();
+			for( std::size_t i = 0; i < doc.size(); i += chunkSize ) {
+				ensure(parser.feed(std::string_view(doc).substr(i,chunkSize)));
+			}
+			ensure(parser.finish());
+			ensure_equals(parser.getHandler().slices, expected);
+			ensure_equals(parser.lastPosition().line, 4);
+		}
+		std::istringstream iss(doc);
+		parser.getHandler().slices.clear();
+		ensure(parser.parse(iss));
+		ensure_equals(parser.getHandler().slices, expected);
+
+		std::string lines = "[1]\n\n{\"k\" : \"v\"}\n";
+		parser.getHandler().input = lines;
+		parser.getHandler().slices.clear();
+		ensure(parser.parseLines(lines));
+		ensure_equals(parser.getHandler().slices, std::vector<std::string>{ "[", "1", "]", "{", "\"v\"", "}" });
+		ensure_equals(parser.getHandler().positions.back().line, 3);
+		ensure_equals(parser.getHandler().positions.back().column, 11);
+
+		// errors get their line and column only when they happen
+		std::string bad = doc;
+		bad[bad.find("null")] = 'x';
+		parser.getHandler().input = bad;
+		ensure_not(parser.throwErrors(false).parse(bad));
+		ensure_equals(parser.error().pos.line, 3);
+		ensure_equals(parser.error().pos.column, 29);
+		for( std::size_t i = 0; i < bad.size() && parser.feed(std::string_view(bad).substr(i,1)); ++i ) {}
+		ensure_equals(parser.error().pos.line, 3);
+		ensure_equals(parser.error().pos.column, 29);
+		parser.finish();
+
+		die::json::Reader reader(doc);
+		std::vector<std::string> tokens;
+		for( auto token = reader.next(); token.kind != die::json::Reader::Kind::end; token = reader.next() ) {
+			tokens.push_back(doc.substr(token.span.offset,token.span.length));
+		}
+		ensure_equals(tokens, expected);
+	}
+}
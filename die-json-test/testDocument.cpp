@@ -0,0 +1,123 @@
+#include <tut.h>
+
+#include "../die-json.h"
+#include <string>
+#include <sstream>
+
+namespace {
+	struct setup {
+	};
+}
+
+namespace tut {
+	typedef test_group<setup> tg;
+	tg parser_test_group("JsonDocument");
+
+	typedef tg::object testobject;
+
+	template<>
+	template<>
+	void testobject::test<1>()
+	{
+		set_test_name("values and lookups");
+		die::json::Document doc;
+		ensure(doc.parse(R"json({
+			"name" : "d\"ie", "count" : 3, "big" : 18446744073709551615, "neg" : -2, "ratio" : 0.25,
+			"ok" : true, "no" : false, "none" : null,
+			"list" : [ 1, [ 2, { "deep" : "x" } ], "three", {} ],
+			"empty" : { }
+		})json"));
+		auto root = doc.root();
+		ensure(root.type() == die::json::Document::Type::object);
+		ensure_equals(root.size(), 10u);
+		ensure_equals(root["name"].asString(), "d\"ie");
+		ensure(root["count"].type() == die::json::Document::Type::int64);
+		ensure_equals(root["count"].asInt64(), 3);
+		ensure_equals(root["count"].asDouble(), 3.0);
+		ensure(root["big"].type() == die::json::Document::Type::uint64);
+		ensure_equals(root["big"].asUInt64(), 18446744073709551615ull);
+		ensure_equals(root["neg"].asInt64(), -2);
+		ensure_equals(root["ratio"].asDouble(), 0.25);
+		ensure(root["ok"].asBool());
+		ensure(root["no"].type() == die::json::Document::Type::boolean);
+		ensure_not(root["no"].asBool());
+		ensure(root["none"].type() == die::json::Document::Type::null);
+
+		auto list = root["list"];
+		ensure_equals(list.size(), 4u);
+		ensure_equals(list[0].asInt64(), 1);
+		ensure_equals(list[1][1]["deep"].asString(), "x");
+		ensure_equals(list[2].asString(), "three");
+		ensure_equals(list[3].size(), 0u);
+		ensure_equals(root["empty"].size(), 0u);
+
+		// misses and wrong types
+		ensure_not(bool(root["missing"]));
+		ensure_not(bool(list[4]));
+		ensure_not(bool(root["name"][0]));
+		ensure_equals(root["name"].asInt64(), 0);
+		ensure_equals(root["count"].asString(), "");
+	}
+
+	template<>
+	template<>
+	void testobject::test<2>()
+	{
+		set_test_name("iteration and reuse");
+		die::json::Document doc;
+		ensure(doc.parse(R"json({ "a" : [1, 2.5, "s"], "b" : { "c" : null }, "d" : 4 })json"));
+		std::string keys;
+		for( auto it = doc.root().begin(); it != doc.root().end(); ++it ) {
+			keys += it.key();
+		}
+		ensure_equals(keys, "abd");
+		double sum = 0;
+		for( auto value : doc.root()["a"] ) {
+			sum += value.asDouble();
+		}
+		ensure_equals(sum, 3.5);
+
+		std::istringstream is("[ [], [[]], 7 ]");
+		ensure(doc.parse(is));
+		ensure(doc.root().type() == die::json::Document::Type::array);
+		ensure_equals(doc.root().size(), 3u);
+		ensure_equals(doc.root()[2].asInt64(), 7);
+		ensure_not(bool(doc.root()["a"]));
+
+		// a big array saturates the count and is counted by walking it
+		std::string big = "[";
+		for( int i = 0; i < 0x1000000 + 5; ++i ) {
+			big += i ? ",0" : "0";
+		}
+		big += "]";
+		ensure(doc.parse(big));
+		ensure_equals(doc.root().size(), std::size_t(0x1000000 + 5));
+	}
+
+	template<>
+	template<>
+	void testobject::test<3>()
+	{
+		set_test_name("failed parses leave the document empty");
+		die::json::Document doc;
+		ensure(doc.parse("{ \"a\" : 1 }"));
+		ensure_not(doc.empty());
+		doc.throwErrors(false);
+		ensure_not(doc.parse("{ \"a\" : 1, }"));
+		ensure(doc.empty());
+		ensure_not(bool(doc.root()));
+		ensure_equals(doc.error().offendingChar, '}');
+		ensure_not(doc.parse("{ \"a\" : "));
+		ensure(doc.error().code == die::json::ErrorCode::incomplete);
+		// an unclosed root is rejected and none of it shows
+		ensure_not(doc.parse("{\"a\":{\"b\":1}"));
+		ensure(doc.error().code == die::json::ErrorCode::incomplete);
+		ensure(doc.empty());
+		ensure_not(bool(doc.root()));
+		ensure_not(bool(doc.root()["x"]));
+		ensure(doc.parse("[1]"));
+		ensure(doc.error().code == die::json::ErrorCode::none);
+		doc.clear();
+		ensure_not(bool(doc.root()));
+	}
+}
@@ -0,0 +1,305 @@
+#include <tut.h>
+
+#include "../die-json.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace {
+	// records events in a compact textual form
+	struct Recorder: die::json::BaseHandler {
+		std::string log;
+		void onStartObject(std::string_view name) { log.append("{").append(name).append(";"); }
+		void onEndObject(std::string_view name) { log.append("}").append(name).append(";"); }
+		void onStartArray(std::string_view name) { log.append("[").append(name).append(";"); }
+		void onEndArray(std::string_view name) { log.append("]").append(name).append(";"); }
+		void onString(std::string_view name, std::string_view value) { log.append(name).append("=s:").append(value).append(";"); }
+		void onNumber(std::string_view name, std::string_view value) { log.append(name).append("=n:").append(value).append(";"); }
+		void onBool(std::string_view name, bool value) { log.append(name).append(value ? "=b:1;" : "=b:0;"); }
+		void onNull(std::string_view name) { log.append(name).append("=null;"); }
+	};
+
+	// keeps the ids found by each worker
+	struct Ids: die::json::BaseHandler {
+		std::vector<int> ids;
+		void onNumber(std::string_view name, std::string_view value)
+		{
+			if( name == "id" ) {
+				ids.push_back(std::stoi(std::string(value)));
+			}
+		}
+	};
+
+	// stops at the given number of strings
+	struct Stopper: die::json::BaseHandler {
+		int strings = 0;
+		int limit = 0;
+		die::json::Control onString(std::string_view, std::string_view)
+		{
+			return ++strings == limit ? die::json::Control::stop : die::json::Control::proceed;
+		}
+	};
+
+	// skips from the end event of the first record
+	struct LineSkipper: Recorder {
+		bool skipped = false;
+		die::json::Control onEndObject(std::string_view name)
+		{
+			Recorder::onEndObject(name);
+			if( skipped ) return die::json::Control::proceed;
+			skipped = true;
+			return die::json::Control::skip;
+		}
+	};
+
+	// returns control from the number at
+	struct Controller: Recorder {
+		std::string at;
+		die::json::Control control = die::json::Control::proceed;
+		die::json::Control onNumber(std::string_view name, std::string_view value)
+		{
+			Recorder::onNumber(name,value);
+			return value == at ? control : die::json::Control::proceed;
+		}
+	};
+
+	struct setup {
+		std::string records(int count)
+		{
+			std::string doc = "[";
+			for( int i = 0; i < count; ++i ) {
+				if( i ) doc += ",\n";
+				doc += " { \"id\" : " + std::to_string(i) + ", \"name\" : \"n\\\"" + std::to_string(i) + "\", \"tags\" : [true, null, 1.5] }";
+			}
+			return doc + "\n]";
+		}
+
+		// the sequential events without the ones of the root array
+		std::string sequential(std::string const & doc)
+		{
+			die::json::BasicParser<Recorder> parser;
+			tut::ensure("sequential parse", parser.parse(doc));
+			auto log = parser.getHandler().log;
+			return log.substr(2,log.size() - 4);
+		}
+	};
+}
+
+namespace tut {
+	typedef test_group<setup> tg;
+	tg parser_test_group("JsonParallel");
+
+	typedef tg::object testobject;
+
+	template<>
+	template<>
+	void testobject::test<1>()
+	{
+		set_test_name("every element reaches one of the workers");
+		auto doc = records(1000);
+		die::json::ParallelParser<Ids> parser;
+		ensure("parsed", parser.threads(3).pieceSize(100).parse(doc));
+		std::vector<int> ids;
+		for( unsigned worker = 0; worker < parser.workers(); ++worker ) {
+			auto & found = parser.getHandler(worker).ids;
+			ids.insert(ids.end(),found.begin(),found.end());
+		}
+		std::sort(ids.begin(),ids.end());
+		ensure_equals(ids.size(), 1000u);
+		for( int i = 0; i < 1000; ++i ) {
+			ensure_equals(ids[i], i);
+		}
+	}
+
+	template<>
+	template<>
+	void testobject::test<2>()
+	{
+		set_test_name("ordered delivery");
+		for( auto doc : { records(300), std::string("[]"), std::string(" [ 1, \"a,]\", [2,[3]], {\"x\":[]} ] ") } ) {
+			for( std::size_t pieceSize : { 1, 7, 64, 1 << 20 } ) {
+				die::json::ParallelParser<Recorder> parser;
+				Recorder recorder;
+				ensure("parsed", parser.threads(4).pieceSize(pieceSize).parseOrdered(doc.data(),doc.size(),recorder));
+				ensure_equals(recorder.log, sequential(doc));
+			}
+		}
+	}
+
+	template<>
+	template<>
+	void testobject::test<3>()
+	{
+		set_test_name("the first error in the document wins");
+		auto doc = records(200);
+		auto first = doc.find("\"id\" : 120");
+		auto second = doc.find("\"id\" : 170");
+		doc[first + 5] = ';';
+		doc[second + 5] = '}';
+
+		die::json::BasicParser<Recorder> sequential;
+		ensure_not(sequential.throwErrors(false).parse(doc));
+
+		die::json::ParallelParser<Recorder> parser;
+		ensure_not("parallel parse", parser.threads(4).pieceSize(50).throwErrors(false).parse(doc));
+		ensure_equals(parser.error().code, sequential.error().code);
+		ensure_equals(parser.error().offendingChar, ';');
+		ensure_equals(parser.error().pos.line, sequential.error().pos.line);
+		ensure_equals(parser.error().pos.column, sequential.error().pos.column);
+
+		Recorder recorder;
+		ensure_not("ordered parse", parser.parseOrdered(doc.data(),doc.size(),recorder));
+		ensure_equals(recorder.log, sequential.getHandler().log.substr(2));
+
+		std::string incomplete = "[1, 2, {\"a\" : [3, 4]}, ";
+		ensure_not(parser.parse(incomplete));
+		ensure_equals(parser.error().code, die::json::ErrorCode::incomplete);
+		ensure_equals(parser.error().pos.column, int(incomplete.size()) + 1);
+	}
+
+	template<>
+	template<>
+	void testobject::test<4>()
+	{
+		set_test_name("stop and other roots");
+		auto doc = records(500);
+		die::json::ParallelParser<Stopper> parser;
+		Stopper stopper;
+		stopper.limit = 321;
+		ensure_not(parser.threads(4).pieceSize(64).parseOrdered(doc.data(),doc.size(),stopper));
+		ensure("stopped", parser.stopped());
+		ensure_equals(stopper.strings, 321);
+
+		die::json::BasicParser<Stopper> sequential;
+		sequential.getHandler().limit = 321;
+		ensure_not(sequential.parse(doc));
+		ensure_equals(parser.stopOffset(), sequential.stopOffset());
+		ensure_equals(doc[parser.stopOffset() - 1], '"');
+
+		std::string lines;
+		for( int i = 0; i < 100; ++i ) {
+			lines += "{ \"id\" : " + std::to_string(i) + ", \"s\" : \"x\" }\n";
+		}
+		Stopper lineStopper;
+		lineStopper.limit = 77;
+		ensure_not(parser.parseLinesOrdered(lines,lineStopper));
+		sequential.getHandler().strings = 0;
+		sequential.getHandler().limit = 77;
+		ensure_not(sequential.parseLines(lines));
+		ensure_equals(parser.stopOffset(), sequential.stopOffset());
+
+		die::json::ParallelParser<Ids> objects;
+		ensure(objects.threads(2).parse(R"json({ "id" : 7, "a" : [ { "id" : 8 } ] })json"));
+		auto & ids = objects.getHandler(0).ids;
+		ensure_equals(ids.size(), 2u);
+		ensure_equals(ids[0], 7);
+		ensure_equals(ids[1], 8);
+	}
+
+	template<>
+	template<>
+	void testobject::test<5>()
+	{
+		set_test_name("JSON Lines on several threads");
+		std::string lines;
+		for( int i = 0; i < 400; ++i ) {
+			lines += i % 97 == 13 ? "{ \"id\" : " + std::to_string(i) + ", }\n" : "{ \"id\" : " + std::to_string(i) + ", \"v\" : [1, \"x\"] }\n";
+			if( i % 50 == 0 ) lines += "\n";
+		}
+
+		die::json::BasicParser<Recorder> sequential;
+		ensure(sequential.isolateLines(true).parseLines(lines));
+		auto const & expected = sequential.badLines();
+		ensure_equals(expected.size(), 4u);
+
+		die::json::ParallelParser<Ids> parser;
+		ensure("isolated", parser.threads(3).pieceSize(200).isolateLines(true).parseLines(lines));
+		std::size_t ids = 0;
+		for( unsigned worker = 0; worker < parser.workers(); ++worker ) {
+			ids += parser.getHandler(worker).ids.size();
+		}
+		ensure_equals(ids, 400u);
+		ensure_equals(parser.badLines().size(), expected.size());
+		for( std::size_t i = 0; i < expected.size(); ++i ) {
+			ensure_equals(parser.badLines()[i].pos.line, expected[i].pos.line);
+			ensure_equals(parser.badLines()[i].pos.column, expected[i].pos.column);
+		}
+
+		die::json::ParallelParser<Recorder> ordered;
+		Recorder recorder;
+		ensure(ordered.threads(4).pieceSize(100).isolateLines(true).parseLinesOrdered(lines,recorder));
+		ensure_equals(recorder.log, sequential.getHandler().log);
+
+		// without isolation the first bad line ends it
+		ensure_not(ordered.isolateLines(false).throwErrors(false).parseLines(lines));
+		ensure_equals(ordered.error().pos.line, expected[0].pos.line);
+	}
+
+	template<>
+	template<>
+	void testobject::test<6>()
+	{
+		set_test_name("a skip at the end of a record leaves the next records alone");
+		std::string lines = "{ \"id\" : 1 }\n{ \"id\" : 2 }\n{ \"id\" : 3, \"v\" : [1] }\n";
+
+		die::json::BasicParser<LineSkipper> sequential;
+		ensure(sequential.parseLines(lines));
+		ensure_equals(sequential.getHandler().log, "{;id=n:1;};{;id=n:2;};{;id=n:3;[v;v=n:1;]v;};");
+
+		for( std::size_t pieceSize : { 1, 1 << 20 } ) {
+			die::json::ParallelParser<Recorder> parser;
+			LineSkipper skipper;
+			ensure(parser.threads(2).pieceSize(pieceSize).parseLinesOrdered(lines,skipper));
+			ensure_equals(skipper.log, sequential.getHandler().log);
+		}
+	}
+	template<>
+	template<>
+	void testobject::test<7>()
+	{
+		set_test_name("a stop or a skipped root before a broken element");
+		std::string doc = "[";
+		for( int i = 1; i <= 30; ++i ) {
+			doc += std::to_string(i) + ",";
+		}
+		doc += "{\"a\":1]]";
+
+		for( auto control : { die::json::Control::stop, die::json::Control::skip } ) {
+			for( auto at : { "1", "15" } ) {
+				die::json::BasicParser<Controller> sequential;
+				sequential.getHandler().at = at;
+				sequential.getHandler().control = control;
+				bool expected = sequential.parse(doc);
+				ensure_equals(expected, control == die::json::Control::skip);
+				ensure_not(bool(sequential.error()));
+				auto log = sequential.getHandler().log.substr(2);
+
+				for( int run = 0; run < 20; ++run ) {
+					die::json::ParallelParser<Recorder> parser;
+					Controller controller;
+					controller.at = at;
+					controller.control = control;
+					ensure_equals(parser.threads(4).pieceSize(4).parseOrdered(doc.data(),doc.size(),controller), expected);
+					ensure_equals(parser.stopped(), sequential.stopped());
+					ensure_not(bool(parser.error()));
+					ensure_equals(controller.log, log);
+				}
+			}
+		}
+
+		// each worker skips the rest of the root from the first element, whichever worker gets it
+		die::json::ParallelParser<Controller> parser([](unsigned) {
+			Controller controller;
+			controller.at = "1";
+			controller.control = die::json::Control::skip;
+			return controller;
+		});
+		for( std::size_t pieceSize : { 4, 1 << 20 } ) {
+			for( int run = 0; run < 20; ++run ) {
+				ensure(parser.threads(4).pieceSize(pieceSize).parse(doc));
+				ensure_not(parser.stopped());
+				ensure_not(bool(parser.error()));
+			}
+		}
+	}
+}
@@ -0,0 +1,146 @@
+#include <tut.h>
+
+#include "../die-json.h"
+#include <sstream>
+#include <vector>
+
+namespace {
+	struct setup {
+		// runs a document and records everything observable: events, result, exception and position
+		std::string record(die::json::Parser::Engine engine, std::string const & toParse, die::json::PathFilter const & filter = {})
+		{
+			std::ostringstream log;
+			die::json::Parser parser;
+			parser
+				.engine(engine)
+				.subscribe(filter)
+				.startObject([&log](auto name) { log << "{" << name << ";"; })
+				.endObject([&log](auto name) { log << "}" << name << ";"; })
+				.startArray([&log](auto name) { log << "[" << name << ";"; })
+				.endArray([&log](auto name) { log << "]" << name << ";"; })
+				.value([&log](auto name, auto type, auto value) { log << name << "," << type << "," << value << ";"; });
+
+			std::istringstream iss(toParse);
+			try {
+				log << " parsed " << parser.parse(iss);
+			} catch(die::json::UnexpectedChar & e) {
+				log << " error " << e.what() << " " << e.offendingChar();
+			}
+			log << " " << parser.lastPosition();
+			return log.str();
+		}
+
+		void sameResults(std::vector<std::string> const & docs, die::json::PathFilter const & filter = {})
+		{
+			for( auto const & doc : docs ) {
+				auto expected = record(die::json::Parser::Engine::automaton,doc,filter);
+				tut::ensure_equals(doc, record(die::json::Parser::Engine::switched,doc,filter), expected);
+				tut::ensure_equals(doc, record(die::json::Parser::Engine::indexed,doc,filter), expected);
+			}
+		}
+	};
+}
+
+namespace tut {
+	typedef test_group<setup> tg;
+	tg parser_test_group("JsonParserEngines");
+
+	typedef tg::object testobject;
+
+	template<>
+	template<>
+	void testobject::test<1>()
+	{
+		set_test_name("same events for valid documents");
+		sameResults({
+			"{}",
+			R"json({ "name" : "\"value\" \ua1B0 \\ \/ \b\f\n\r\t" })json",
+			"{ \"n\" : null, \"t\":true,\n\"f\" : false }",
+			"{ \"a\" : [ 0, -0.5, 1029, -4.5E-2878, 77.66e+20, 55E+88, 0.55e10 ] }",
+			R"json({ "o" : [ 1, { "z":0, "s" : "v" }, [1,2,[]], {}, { "six": [7,8,9], "ten" : null } ] })json",
+			"[]",
+			R"json( [ 1, "a", { "b" : [ true ] }, [ -2.5e3 ], null ] )json",
+		});
+	}
+
+	template<>
+	template<>
+	void testobject::test<2>()
+	{
+		set_test_name("same errors for invalid documents");
+		sameResults({
+			" auu {}",
+			"{}}",
+			"[truex]",
+			"[1 2]",
+			"[ \"a\"x ]",
+			"[1,\n  nul ]",
+			"{ \"a\" : 12a }",
+			"[ 1 \\\" ]",
+			"{ \"a\":[1,2]] }",
+			" { ",
+			"{ \"a\":1, }",
+			"{ \"a\" 1 }",
+			"{ \"a\", 1 }",
+			"{ \"a\" : [\"hey\" : \"hey\"] }",
+			"{ \"\" : 1 }",
+			"{ \"a\" : 1.2.3 }",
+			"{ \"a\" : 1e5e }",
+			"{ \"a\" : \"\\uZZZZ\" }",
+			"{ \"a\" : \"\\ud800x\" }",
+			"{ \"a\" : \"\\udc00\" }",
+			"{ \"a\" : nul }",
+			"{},{}",
+			"[1,2",
+			"[],[]",
+			"[1}",
+		});
+	}
+
+	template<>
+	template<>
+	void testobject::test<3>()
+	{
+		set_test_name("indexed engine across blocks and windows");
+		std::vector<std::string> docs;
+		// runs of backslashes and quotes ending at every offset around a 64 byte block boundary
+		for( std::size_t pad = 50; pad < 70; ++pad ) {
+			for( std::size_t slashes = 1; slashes < 8; ++slashes ) {
+				auto doc = "{\"" + std::string(pad,'k') + std::string(slashes,'\\') + "\" : [\"x\\\"{\", 1, {\"}\":\"]\"}] }";
+				docs.push_back(doc);
+				docs.push_back(doc.substr(0,doc.size() - 3));
+			}
+		}
+		// strings and arrays longer than a window
+		std::string big = "{\"s\" : \"";
+		for( int i = 0; i < 9000; ++i ) {
+			big += "abc\\n\\\"";
+		}
+		big += "\", \"a\" : [";
+		for( int i = 0; i < 20000; ++i ) {
+			big += "{\"k\":\"v,]\"},\n";
+		}
+		big += "0] }";
+		docs.push_back(big);
+		docs.push_back(big.substr(0,100000));
+		sameResults(docs);
+		// the skipped subtrees are walked through the index too
+		sameResults(docs,die::json::PathFilter().add("/s"));
+
+		// the index carries strings and escapes over chunks fed in pieces
+		std::string fed;
+		die::json::Parser parser;
+		parser
+			.engine(die::json::Parser::Engine::indexed)
+			.value([&fed](auto name, auto type, auto value) { fed += value; });
+		for( std::size_t i = 0; i < big.size(); i += 61 ) {
+			ensure(parser.feed(std::string_view(big).substr(i,61)));
+		}
+		ensure(parser.finish());
+		std::string parsed;
+		die::json::Parser whole;
+		whole.value([&parsed](auto name, auto type, auto value) { parsed += value; });
+		ensure(whole.parse(big));
+		ensure_equals(fed, parsed);
+	}
+}
@@ -2,6 +2,9 @@
 
 #include "../die-json.h"
 #include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
 
 namespace {
 	struct setup {
@@ -134,5 +137,141 @@ namespace tut {
 		ensure_equals(pos.line, 1);
 		ensure_equals(pos.column, 16);
 	}
-}
 
+	template<>
+	template<>
+	void testobject::test<9>()
+	{
+		set_test_name("position after multiline string");
+		didNotFinish("{ \"a\" : \"x\ny\" 1 }",2,4);
+	}
+
+	template<>
+	template<>
+	void testobject::test<10>()
+	{
+		set_test_name("position after long indentation");
+		didNotFinish("{\n" + std::string(40,' ') + "\"a\" : 1,\n" + std::string(50,' ') + "\t\r\n" + std::string(37,' ') + "}",4,38);
+	}
+
+	template<>
+	template<>
+	void testobject::test<11>()
+	{
+		set_test_name("push parser rejects chunk");
+		ensure("first chunk is fine", parser.feed("{ \"a\" :\n 1"));
+		ensure_not("second chunk has garbage", parser.feed("2 x }"));
+		ensure_not("rejected parser does not resume", parser.feed("}"));
+		ensure_not("rejected document should not finish", parser.finish());
+		auto pos = parser.lastPosition();
+		ensure_equals(pos.line, 2);
+		ensure_equals(pos.column, 5);
+
+		ensure("new document after finish", parser.feed("{}"));
+		ensure("parser did not reach final state", parser.finish());
+	}
+
+	template<>
+	template<>
+	void testobject::test<12>()
+	{
+		set_test_name("lone surrogates");
+		std::vector<std::tuple<std::string,char,int>> docs = {
+			{ R"json({ "a" : "\udc00" })json", '0', 15 },
+			{ R"json({ "a" : "\ud800x" })json", 'x', 16 },
+			{ R"json({ "a" : "\ud800" })json", '"', 16 },
+			{ R"json({ "a" : "\ud800\n" })json", 'n', 17 },
+			{ R"json({ "a" : "\ud800\u0041" })json", '1', 21 },
+		};
+		for( auto & [doc, ch, column] : docs ) {
+			bool error = false;
+			try {
+				parser.parse(doc);
+			} catch(die::json::LoneSurrogate & e) {
+				error = true;
+				ensure_equals(e.offendingChar(), ch);
+			}
+			ensure("parser should have thrown exception", error);
+			auto pos = parser.lastPosition();
+			ensure_equals(pos.line, 1);
+			ensure_equals(pos.column, column);
+		}
+	}
+
+	template<>
+	template<>
+	void testobject::test<13>()
+	{
+		set_test_name("skipped subtree closed by the wrong bracket");
+		parser.subscribe({"/b"});
+		bool error = false;
+		try {
+			parser.parse("{ \"a\" : { \"x\" : [1, \"]\"]\n ], \"b\" : 1 }");
+		} catch(die::json::UnexpectedArrayClosing & e) {
+			error = true;
+			ensure_equals(e.offendingChar(), ']');
+		}
+		ensure("parser should have thrown exception", error);
+		auto pos = parser.lastPosition();
+		ensure_equals(pos.line, 2);
+		ensure_equals(pos.column, 2);
+	}
+
+	template<>
+	template<>
+	void testobject::test<14>()
+	{
+		set_test_name("error codes instead of exceptions");
+		using die::json::ErrorCode;
+		std::vector<std::tuple<std::string,ErrorCode,char,int>> docs = {
+			{ "{}}", ErrorCode::unexpectedObjectClosing, '}', 3 },
+			{ "{ \"a\":[1,2]] }", ErrorCode::unexpectedArrayClosing, ']', 12 },
+			{ "{ \"a\", 1 }", ErrorCode::expectedChar, ',', 6 },
+			{ "{ \"a\" : [\"hey\" : \"hey\"] }", ErrorCode::unexpectedChar, ':', 16 },
+			{ "{ \"\" : 1 }", ErrorCode::emptyObjectName, '"', 4 },
+			{ "{ \"a\" : \"\\udc00\" }", ErrorCode::loneSurrogate, '0', 15 },
+			{ "{ \"a\" : 1.2.3 }", ErrorCode::unexpectedChar, '.', 12 },
+			{ "{ \"a\" 1 }", ErrorCode::rejectedChar, '1', 7 },
+			{ "{ \"a\" : [1", ErrorCode::incomplete, 0, 11 },
+			{ "{ \"a\" : {}", ErrorCode::incomplete, 0, 11 },
+			{ "[[1], [2]", ErrorCode::incomplete, 0, 10 },
+		};
+		for( auto & [doc, code, ch, column] : docs ) {
+			std::string thrown;
+			try {
+				parser.throwErrors(true).parse(doc);
+			} catch(die::json::Exception & e) {
+				thrown = e.what();
+			}
+
+			ensure_not("parse should fail", parser.throwErrors(false).parse(doc));
+			auto & error = parser.error();
+			ensure("error should be set", bool(error));
+			ensure_equals(error.code, code);
+			ensure_equals(error.offendingChar, ch);
+			ensure_equals(error.pos.line, 1);
+			ensure_equals(error.pos.column, column);
+			ensure_equals(parser.lastPosition().column, column);
+			if( ! thrown.empty() ) {
+				ensure_equals(error.message(), thrown);
+			}
+		}
+
+		ensure_not(parser.parse("{ \"a\" 1 }"));
+		ensure("the grammar takes a colon there", parser.error().acceptedChars[':']);
+		ensure_equals(parser.error().message(), "(line 1, column 7) rejected char 1 but expected one of , : ] }");
+		ensure_not(parser.parse("[nul!]"));
+		ensure_equals(parser.error().message(), "(line 1, column 5) rejected char ! but expected one of l");
+		ensure_not(parser.parse("[\"\\u12g\"]"));
+		ensure_equals(parser.error().message(), "(line 1, column 7) rejected char g but expected one of 0-9 A-F a-f");
+
+		ensure("valid document", parser.parse("{}"));
+		ensure_not("no error after a valid document", bool(parser.error()));
+
+		ensure("first chunk is fine", parser.feed("{ \"a\" : 1"));
+		ensure_not("second chunk has an error", parser.feed(", \"b\" : 1]"));
+		ensure_equals(parser.error().code, ErrorCode::unexpectedArrayClosing);
+		ensure_equals(parser.error().pos.column, 19);
+		ensure_not(parser.finish());
+	}
+}
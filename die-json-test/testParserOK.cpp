@@ -2,6 +2,9 @@
 
 #include "../die-json.h"
 #include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <system_error>
 #include <iostream>
 #include <vector>
 #include <memory>
@@ -140,7 +143,7 @@ namespace tut {
 		set_test_name("string with escape and unicode");
 		parseSingleValue(R"json({ "name" : "\"value\" \ua1B0 \\ \/ \b\f\n\r\t" })json",
 			die::json::ValueType::string,
-			std::string(R"json("value" \ua1B0 \ / )json") + '\b' + '\f' + '\n' + '\r' + '\t');
+			std::string("\"value\" \xEA\x86\xB0 \\ / ") + '\b' + '\f' + '\n' + '\r' + '\t');
 	}
 
 	template<>
@@ -423,4 +426,260 @@ namespace tut {
 		ensure_equals(arrays[6], "myObjects]");
 		ensure_equals(arrays[7], "myObjects]");
 	}
+
+	template<>
+	template<>
+	void testobject::test<12>()
+	{
+		set_test_name("long strings with escapes");
+
+		std::string json = "{ \"name\" : \"";
+		std::string expected;
+		for( int i = 0; i < 3000; ++i ) {
+			json += "plain text run \\n\\\"\\u00e9 ";
+			expected += "plain text run \n\"\xC3\xA9 ";
+		}
+		json += "\" }";
+		parseSingleValue(json,die::json::ValueType::string,expected);
+	}
+
+	template<>
+	template<>
+	void testobject::test<13>()
+	{
+		set_test_name("parse from memory");
+
+		std::vector<Value> values;
+		parser.value([&values](auto name, auto type, auto value) {
+			values.push_back({name,type,value});
+		});
+
+		std::string json = "{ \"str\" : \"value\", \"num\" : [1,2.5] }";
+		ensure("parser did not reach final state", parser.parse(json.data(),json.size()));
+		ensure("parser did not reach final state", parser.parse(std::string_view(json)));
+		ensure_equals(values.size(), 6);
+		for( int i = 0; i < 3; ++i ) {
+			ensure_equals(values[i], values[i+3]);
+		}
+		ensure_equals(values[0], Value{"str", die::json::ValueType::string, "value"});
+		ensure_equals(values[2], Value{"num", die::json::ValueType::number, "2.5"});
+
+		ensure_not("truncated document should not finish", parser.parse(json.data(),json.size()-4));
+	}
+
+	template<>
+	template<>
+	void testobject::test<14>()
+	{
+		set_test_name("zero-copy views");
+
+		std::string json = R"json({ "plain" : "value", "esc\"aped" : "a\tb", "nested" : { "n" : -12.5e3, "k" : [true] } })json";
+		auto inInput = [&json](std::string_view view) {
+			return view.data() >= json.data() && view.data() + view.size() <= json.data() + json.size();
+		};
+		std::vector<Value> values;
+		std::vector<std::string> names;
+		parser
+			.startObjectView([&names](auto name) {
+				names.emplace_back(name);
+			})
+			.valueView([&values,&inInput](auto name, auto type, auto value) {
+				values.push_back({std::string(name),type,std::string(value)});
+				ensure_equals("only escaped values are copied", inInput(value), value.find('\t') == std::string_view::npos);
+				ensure_equals("only escaped names are copied", inInput(name), name.find('"') == std::string_view::npos);
+			});
+
+		ensure("parser did not reach final state", parser.parse(json));
+		ensure_equals(values.size(), 4);
+		ensure_equals(values[0], Value{"plain", die::json::ValueType::string, "value"});
+		ensure_equals(values[1], Value{"esc\"aped", die::json::ValueType::string, "a\tb"});
+		ensure_equals(values[2], Value{"n", die::json::ValueType::number, "-12.5e3"});
+		ensure_equals(values[3], Value{"k", die::json::ValueType::boolean, "true"});
+		ensure_equals(names.size(), 2);
+		ensure_equals(names[1], "nested");
+	}
+
+	template<>
+	template<>
+	void testobject::test<15>()
+	{
+		set_test_name("tokens across stream blocks");
+
+		std::string json = "{ \"values\" : [";
+		for( int i = 0; i < 10000; ++i ) {
+			json += std::to_string(i * 1234567LL) + ",null,\"s" + std::to_string(i) + "\",";
+		}
+		json += "false] }";
+
+		std::vector<Value> fromStream, fromMemory;
+		parser.value([&fromStream](auto name, auto type, auto value) {
+			fromStream.push_back({name,type,value});
+		});
+		istringstream iss(json);
+		ensure("parser did not reach final state", parser.parse(iss));
+		parser.value([&fromMemory](auto name, auto type, auto value) {
+			fromMemory.push_back({name,type,value});
+		});
+		ensure("parser did not reach final state", parser.parse(json));
+		ensure_equals(fromStream.size(), 30001);
+		ensure("stream and memory events differ", fromStream == fromMemory);
+	}
+
+	template<>
+	template<>
+	void testobject::test<16>()
+	{
+		set_test_name("parse mapped file");
+
+		auto const fileName = "die-json-test-file.json";
+		std::ofstream(fileName) << "{ \"name\" : \"value\", \"array\" : [1, 2] }";
+
+		std::vector<Value> values;
+		parser.value([&values](auto name, auto type, auto value) {
+			values.push_back({name,type,value});
+		});
+		auto parsed = parser.parseFile(fileName);
+		std::remove(fileName);
+		ensure("parser did not reach final state", parsed);
+		ensure_equals(values.size(), 3);
+		ensure_equals(values[0], Value{"name", die::json::ValueType::string, "value"});
+		ensure_equals(values[2], Value{"array", die::json::ValueType::number, "2"});
+
+		bool error = false;
+		try {
+			parser.parseFile("there/is/no/such/file.json");
+		} catch(std::system_error &) {
+			error = true;
+		}
+		ensure("missing file should throw", error);
+	}
+
+	template<>
+	template<>
+	void testobject::test<17>()
+	{
+		set_test_name("push parser in chunks");
+
+		std::string json = R"json({ "name" : "val\"ue \u00e9", "n\tum" : [-1.5e+3, 0, 12, true, null, {}], "o" : { "f" : false } })json";
+		std::vector<Value> whole;
+		parser.value([&whole](auto name, auto type, auto value) {
+			whole.push_back({name,type,value});
+		});
+		ensure("parser did not reach final state", parser.parse(json));
+		ensure_equals(whole.size(), 7);
+
+		for( std::size_t chunkSize = 1; chunkSize < 8; ++chunkSize ) {
+			std::vector<Value> chunked;
+			parser.value([&chunked](auto name, auto type, auto value) {
+				chunked.push_back({name,type,value});
+			});
+			for( std::size_t i = 0; i < json.size(); i += chunkSize ) {
+				ensure("chunk was rejected", parser.feed(std::string_view(json).substr(i,chunkSize)));
+			}
+			ensure("parser did not reach final state", parser.finish());
+			ensure("chunked events differ", chunked == whole);
+		}
+
+		ensure("partial document", parser.feed("{ \"a\" : [1"));
+		ensure_not("partial document should not finish", parser.finish());
+	}
+
+	template<>
+	template<>
+	void testobject::test<18>()
+	{
+		set_test_name("unicode escapes decoded to utf-8");
+
+		std::string json = R"json({ "name" : "\u0041\u00e9\u20AC\ud83d\ude00 x" })json";
+		std::string expected = "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80 x";
+		parseSingleValue(json,die::json::ValueType::string,expected);
+
+		// escapes split at every possible point go through the automaton
+		std::string value;
+		parser.value([&value](auto name, auto type, auto v) { value = v; });
+		for( std::size_t chunkSize = 1; chunkSize < 8; ++chunkSize ) {
+			value.clear();
+			for( std::size_t i = 0; i < json.size(); i += chunkSize ) {
+				ensure("chunk was rejected", parser.feed(std::string_view(json).substr(i,chunkSize)));
+			}
+			ensure("parser did not reach final state", parser.finish());
+			ensure_equals(value, expected);
+		}
+	}
+
+	template<>
+	template<>
+	void testobject::test<19>()
+	{
+		set_test_name("current path");
+
+		std::vector<std::string> pointers;
+		auto record = [this,&pointers](auto &&...) { pointers.push_back(parser.currentPath().pointer()); };
+		parser.startObject(record).endObject(record).startArray(record).endArray(record).value(record);
+		std::string json = R"json({ "a" : [1, {"b" : true}, [], ["x", null]], "c/d~" : { "e" : 2 }, "f" : 3 })json";
+		for( std::size_t blockSize : { json.size(), std::size_t(3) } ) {
+			pointers.clear();
+			for( std::size_t i = 0; i < json.size(); i += blockSize ) {
+				ensure("chunk was rejected", parser.feed(std::string_view(json).substr(i,blockSize)));
+			}
+			ensure("parser did not reach final state", parser.finish());
+			ensure_equals(pointers, std::vector<std::string>{
+				"", "/a", "/a/0", "/a/1", "/a/1/b", "/a/1", "/a/2", "/a/2", "/a/3", "/a/3/0", "/a/3/1", "/a/3", "/a",
+				"/c~1d~0", "/c~1d~0/e", "/c~1d~0", "/f", "",
+			});
+		}
+
+		auto & path = parser.currentPath();
+		std::vector<std::string> segments;
+		parser.value([&](auto &&...) {
+			for( std::size_t i = 0; i < path.depth(); ++i ) {
+				segments.push_back(path.isIndex(i) ? std::to_string(path.index(i)) : std::string(path.key(i)));
+			}
+		});
+		ensure("parser did not reach final state", parser.parse(R"json({ "k" : [0, [1, 2]] })json"));
+		ensure_equals(segments, std::vector<std::string>{ "k", "0", "k", "1", "0", "k", "1", "1" });
+	}
+
+	template<>
+	template<>
+	void testobject::test<20>()
+	{
+		set_test_name("path subscriptions");
+
+		std::vector<std::string> events;
+		auto record = [this,&events](char const * kind) {
+			return [this,&events,kind](auto &&...) { events.push_back(kind + parser.currentPath().pointer()); };
+		};
+		parser.subscribe({"/events/*/user/id", "/meta", "/events/1/tags/0"})
+			.startObject(record("{")).endObject(record("}")).startArray(record("[")).endArray(record("]"));
+		parser.value([this,&events](auto name, auto type, auto value) {
+			events.push_back(parser.currentPath().pointer() + "=" + value);
+		});
+		std::string json = R"json({ "skip" : { "a" : [1, {"b" : "}]\"{["}], "c" : null }, "events" : [
+			{ "user" : { "id" : 7, "name" : "x" }, "tags" : ["t0"] },
+			{ "user" : { "name" : "y", "id" : "u8" }, "tags" : ["t1", "t2"], "other" : [[[]]] },
+			{ "id" : 9, "user" : [] }
+		], "meta" : { "v" : [1, 2] }, "last" : true })json";
+		std::vector<std::string> expected = {
+			"/events/0/user/id=7", "/events/1/user/id=u8", "/events/1/tags/0=t1",
+			"{/meta", "[/meta/v", "/meta/v/0=1", "/meta/v/1=2", "]/meta/v", "}/meta",
+		};
+		ensure("parser did not reach final state", parser.parse(json));
+		ensure_equals(events, expected);
+
+		for( std::size_t chunkSize = 1; chunkSize < 5; ++chunkSize ) {
+			events.clear();
+			for( std::size_t i = 0; i < json.size(); i += chunkSize ) {
+				ensure("chunk was rejected", parser.feed(std::string_view(json).substr(i,chunkSize)));
+			}
+			ensure("parser did not reach final state", parser.finish());
+			ensure_equals(events, expected);
+		}
+		ensure_equals(parser.lastPosition().line, 5);
+
+		parser.subscribe({""});
+		events.clear();
+		ensure("parser did not reach final state", parser.parse(R"json({ "a" : [1] })json"));
+		ensure_equals(events, std::vector<std::string>{ "{", "[/a", "/a/0=1", "]/a", "}" });
+	}
 }
@@ -0,0 +1,160 @@
+#include <tut.h>
+
+#include "../die-json.h"
+#include <string>
+
+namespace {
+	using Kind = die::json::Reader::Kind;
+
+	// records events in the same form as setup::read()
+	struct Recorder: die::json::BaseHandler {
+		std::string log;
+		void onStartObject(std::string_view name) { log.append(name).append("{;"); }
+		void onEndObject(std::string_view name) { log.append(name).append("};"); }
+		void onStartArray(std::string_view name) { log.append(name).append("[;"); }
+		void onEndArray(std::string_view name) { log.append(name).append("];"); }
+		void onString(std::string_view name, std::string_view value) { log.append(name).append("=s:").append(value).append(";"); }
+		void onNumber(std::string_view name, std::string_view value) { log.append(name).append("=n:").append(value).append(";"); }
+		void onBool(std::string_view name, bool value) { log.append(name).append(value ? "=b:true;" : "=b:false;"); }
+		void onNull(std::string_view name) { log.append(name).append("=null;"); }
+	};
+
+	struct setup {
+		std::string read(die::json::Reader & reader)
+		{
+			std::string log;
+			for(;;) {
+				auto const & token = reader.next();
+				switch(token.kind) {
+					case Kind::end: return log;
+					case Kind::startObject: log.append(token.key).append("{;"); break;
+					case Kind::endObject: log.append(token.key).append("};"); break;
+					case Kind::startArray: log.append(token.key).append("[;"); break;
+					case Kind::endArray: log.append(token.key).append("];"); break;
+					case Kind::string: log.append(token.key).append("=s:").append(token.value).append(";"); break;
+					case Kind::number: log.append(token.key).append("=n:").append(token.value).append(";"); break;
+					case Kind::boolean: log.append(token.key).append("=b:").append(token.value).append(";"); break;
+					case Kind::null: log.append(token.key).append("=null;"); break;
+				}
+			}
+		}
+	};
+}
+
+namespace tut {
+	typedef test_group<setup> tg;
+	tg parser_test_group("JsonReader");
+
+	typedef tg::object testobject;
+
+	template<>
+	template<>
+	void testobject::test<1>()
+	{
+		set_test_name("tokens match the events");
+		char const * docs[] = {
+			R"json({ "a" : 1, "b" : [ 2, 3.5e1, -0 ], "c" : { "d\"e" : 4 }, "f" : "x\ny", "g" : true, "h" : null })json",
+			R"json([1,[2,[3]],{"kA":-1},{},[],"s",false])json",
+			R"json({"esc\\aped":[{"x":1}],"n":10})json",
+			"",
+		};
+		for( auto doc : docs ) {
+			for( auto engine : { die::json::Engine::automaton, die::json::Engine::switched, die::json::Engine::indexed } ) {
+				die::json::BasicParser<Recorder> parser;
+				ensure(parser.engine(engine).parse(std::string_view(doc)));
+				die::json::Reader reader(doc);
+				reader.engine(engine);
+				ensure_equals(read(reader), parser.getHandler().log);
+				ensure("the end stays", reader.next().kind == Kind::end);
+				ensure_not(bool(reader.error()));
+			}
+		}
+	}
+
+	template<>
+	template<>
+	void testobject::test<2>()
+	{
+		set_test_name("skipping");
+		std::string doc = R"json({ "skip" : { "a" : [1, {"b" : "]"}] }, "keep" : [ 1, 2, 3 ], "last" : 5 })json";
+		die::json::Reader reader(doc);
+		ensure(reader.next().kind == Kind::startObject);
+		auto const & skipped = reader.next();
+		ensure(skipped.kind == Kind::startObject);
+		ensure_equals(skipped.key, "skip");
+		reader.skip();
+		auto const & keep = reader.next();
+		ensure(keep.kind == Kind::startArray);
+		ensure_equals(keep.key, "keep");
+		ensure_equals(reader.next().value, "1");
+		reader.skip();
+		auto const & last = reader.next();
+		ensure_equals(last.key, "last");
+		ensure_equals(last.value, "5");
+		reader.skip();	// drops the end of the root
+		ensure("end", reader.next().kind == Kind::end);
+		ensure_not(bool(reader.error()));
+
+		reader.reset(doc);
+		reader.next();
+		reader.skip();
+		ensure("all of it", reader.next().kind == Kind::end);
+	}
+
+	template<>
+	template<>
+	void testobject::test<3>()
+	{
+		set_test_name("errors and offsets");
+		std::string doc = "{ \"a\" : [1, 2}";
+		die::json::Reader reader(doc);
+		reader.throwErrors(false);
+		ensure(reader.next().kind == Kind::startObject);
+		ensure_equals(reader.offset(), 1u);
+		ensure(reader.next().kind == Kind::startArray);
+		ensure_equals(reader.offset(), 9u);
+		ensure_equals(reader.next().value, "1");
+		ensure_equals(reader.offset(), 11u);
+		ensure("error", reader.next().kind == Kind::end);
+		ensure(reader.error().code == die::json::ErrorCode::unexpectedObjectClosing);
+		ensure(reader.next().kind == Kind::end);
+
+		die::json::Reader incomplete("[1, 2");
+		incomplete.throwErrors(false);
+		ensure_equals(read(incomplete), "[;=n:1;");
+		ensure(incomplete.error().code == die::json::ErrorCode::incomplete);
+	}
+	template<>
+	template<>
+	void testobject::test<4>()
+	{
+		set_test_name("indexed reader across windows");
+		std::string doc = "[";
+		for( int i = 0; i < 5000; ++i ) {
+			if( i ) doc += ",\n";
+			doc += "{ \"id\" : " + std::to_string(i) + ", \"s\" : \"a\\\"]}[{" + std::to_string(i) + "\", \"skip\" : [ { \"x\" : \"}\" } ], \"t\" : [true, null] }";
+		}
+		doc += "]";
+		ensure("several windows", doc.size() > 4 * 64 * 1024);
+
+		auto walk = [&doc](die::json::Engine engine) {
+			std::string log;
+			die::json::Reader reader(doc);
+			reader.engine(engine);
+			for(;;) {
+				auto const & token = reader.next();
+				if( token.kind == Kind::end ) break;
+				log.append(token.key).append(":").append(token.value).append(";");
+				if( token.kind == Kind::startArray && token.key == "skip" ) {
+					reader.skip();
+				}
+			}
+			ensure_not(bool(reader.error()));
+			return log;
+		};
+		auto log = walk(die::json::Engine::switched);
+		ensure_equals(walk(die::json::Engine::indexed), log);
+		ensure("skipped", log.find("x:") == std::string::npos);
+		ensure("all there", log.find("id:4999;") != std::string::npos);
+	}
+}
@@ -0,0 +1,104 @@
+#include <tut.h>
+
+#include "../die-json.h"
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace {
+	struct setup {
+		// parses doc straight into a writer
+		std::string rewrite(std::string const & doc, int indent = 0)
+		{
+			die::json::Writer writer;
+			writer.indent(indent);
+			die::json::BasicParser<die::json::Writer> parser(std::move(writer));
+			tut::ensure("parse", parser.parse(doc));
+			return std::string(parser.getHandler().text());
+		}
+	};
+}
+
+namespace tut {
+	typedef test_group<setup> tg;
+	tg parser_test_group("JsonWriter");
+
+	typedef tg::object testobject;
+
+	template<>
+	template<>
+	void testobject::test<1>()
+	{
+		set_test_name("parser into writer");
+		ensure_equals(rewrite(R"json( { "a" : [ 1, -2.5e3, "x" ], "b" : { "c" : null, "d" : true }, "e" : [], "f" : {} } )json"),
+			R"json({"a":[1,-2.5e3,"x"],"b":{"c":null,"d":true},"e":[],"f":{}})json");
+		ensure_equals(rewrite(R"json([{"k\"ey":"tab\tquote\"slash\\\u0001é"}])json"),
+			R"json([{"k\"ey":"tab\tquote\"slash\\\u0001)json" "\xC3\xA9" R"json("}])json");
+		ensure_equals(rewrite(R"json({"a":[1,{"b":[]}],"c":{}})json",2),
+			"{\n"
+			"  \"a\": [\n"
+			"    1,\n"
+			"    {\n"
+			"      \"b\": []\n"
+			"    }\n"
+			"  ],\n"
+			"  \"c\": {}\n"
+			"}");
+	}
+
+	template<>
+	template<>
+	void testobject::test<2>()
+	{
+		set_test_name("typed numbers");
+		die::json::Writer writer;
+		writer.onStartArray("");
+		writer.onNumber("",0.1);
+		writer.onNumber("",1.0);
+		writer.onNumber("",-0.0);
+		writer.onNumber("",1e300);
+		writer.onNumber("",std::numeric_limits<double>::quiet_NaN());
+		writer.onNumber("",-42);
+		writer.onNumber("",std::numeric_limits<std::int64_t>::min());
+		writer.onNumber("",std::numeric_limits<std::uint64_t>::max());
+		writer.onNumber("",7u);
+		writer.onEndArray("");
+		ensure_equals(writer.text(), "[0.1,1.0,-0.0,1e+300,null,-42,-9223372036854775808,18446744073709551615,7]");
+
+		// shortest round trip
+		for( double value : { 1.0 / 3, 2.0 / 3 * 1e-200, 123456789.125, 5e-324 } ) {
+			die::json::Writer one;
+			one.onNumber("",value);
+			ensure_equals(std::strtod(std::string(one.text()).c_str(),nullptr), value);
+		}
+	}
+
+	template<>
+	template<>
+	void testobject::test<3>()
+	{
+		set_test_name("stream sink in blocks");
+		std::ostringstream os;
+		{
+			die::json::Writer writer(os,64);
+			writer.onStartObject("");
+			for( int i = 0; i < 100; ++i ) {
+				writer.onString("key" + std::to_string(i),"some value");
+			}
+			ensure("blocks went out", os.str().size() >= 64);
+			ensure("the rest is buffered", writer.text().size() < 64 + 32);
+			writer.onEndObject("");
+			writer.onStartArray("");
+			writer.onEndArray("");
+		}
+		auto text = os.str();
+		ensure_equals(text.substr(0,20), "{\"key0\":\"some value\"");
+		ensure_equals(text.substr(text.size() - 4), "}\n[]");
+
+		// what was written parses back to the same events
+		auto doc = text.substr(0,text.size() - 3);
+		ensure_equals(rewrite(doc), doc);
+	}
+}
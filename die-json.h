@@ -1,2 +1,7 @@
 #include "src/JsonParser.h"
 #include "src/JsonParserExceptions.h"
+#include "src/JsonParserFile.h"
+#include "src/JsonParallel.h"
+#include "src/JsonDocument.h"
+#include "src/JsonReader.h"
+#include "src/JsonWriter.h"
@@ -0,0 +1,1710 @@
+#ifndef JSONBASICPARSER_H_DIE_JSON_2026_10_17
+#define JSONBASICPARSER_H_DIE_JSON_2026_10_17
+
+#include <string>
+#include <string_view>
+#include <stack>
+#include <deque>
+#include <chrono>
+#include <vector>
+#include <istream>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include "JsonParserObjects.h"
+#include "JsonKeySet.h"
+#include "JsonPath.h"
+#include "JsonPathFilter.h"
+#include "JsonParserExceptions.h"
+#include "JsonParserGrammar.h"
+#include "JsonParserNumbers.h"
+#include "JsonParserSimd.h"
+#include "JsonParserIndex.h"
+#include "JsonParserFile.h"
+#include "JsonParserStats.h"
+
+namespace die {
+namespace json {
+
+// appends decoded \u escapes in the encoding of the value strings
+// the default is UTF-8. specialize it for other char types
+template<typename CharType>
+struct CharTraits {
+	template<typename String>
+	static void appendCodePoint(String & str, char32_t cp)
+	{
+		if( cp < 0x80 ) {
+			str.push_back(CharType(cp));
+		} else if( cp < 0x800 ) {
+			str.push_back(CharType(0xC0 | (cp >> 6)));
+			str.push_back(CharType(0x80 | (cp & 0x3F)));
+		} else if( cp < 0x10000 ) {
+			str.push_back(CharType(0xE0 | (cp >> 12)));
+			str.push_back(CharType(0x80 | ((cp >> 6) & 0x3F)));
+			str.push_back(CharType(0x80 | (cp & 0x3F)));
+		} else {
+			str.push_back(CharType(0xF0 | (cp >> 18)));
+			str.push_back(CharType(0x80 | ((cp >> 12) & 0x3F)));
+			str.push_back(CharType(0x80 | ((cp >> 6) & 0x3F)));
+			str.push_back(CharType(0x80 | (cp & 0x3F)));
+		}
+	}
+};
+
+template<>
+struct CharTraits<char16_t> {
+	template<typename String>
+	static void appendCodePoint(String & str, char32_t cp)
+	{
+		if( cp < 0x10000 ) {
+			str.push_back(char16_t(cp));
+		} else {
+			cp -= 0x10000;
+			str.push_back(char16_t(0xD800 | (cp >> 10)));
+			str.push_back(char16_t(0xDC00 | (cp & 0x3FF)));
+		}
+	}
+};
+
+template<>
+struct CharTraits<char32_t> {
+	template<typename String>
+	static void appendCodePoint(String & str, char32_t cp) { str.push_back(cp); }
+};
+
+// BasicParser calls its handler directly, so the events can be inlined. derive from BaseHandler to get no-op defaults
+// names and values are only valid during the call
+struct BaseHandler {
+	void onStartObject(std::string_view) {}
+	void onEndObject(std::string_view) {}
+	void onStartArray(std::string_view) {}
+	void onEndArray(std::string_view) {}
+	void onString(std::string_view, std::string_view) {}
+	void onNumber(std::string_view, std::string_view) {}
+	void onBool(std::string_view, bool) {}
+	void onNull(std::string_view) {}
+};
+
+// any event may return a Control instead of void. skip from a start event skips that object or array
+// from the other events it skips the rest of the innermost open one. either way the skipped end event is not called
+// stop ends the parse right after the event. the parse returns false and stopped() tells it apart from an error
+
+// typed numbers are opt-in: a handler with onInt64, onUInt64 and onDouble gets them instead of onNumber
+// integers go to onInt64 when they fit, then to onUInt64. everything else goes to onDouble
+// the lexeme is passed along for exact decimal use
+template<typename H, typename = void>
+struct has_typed_numbers: std::false_type {};
+
+template<typename H>
+struct has_typed_numbers<H,std::void_t<
+	decltype(std::declval<H &>().onInt64(std::string_view(),std::int64_t(),std::string_view())),
+	decltype(std::declval<H &>().onUInt64(std::string_view(),std::uint64_t(),std::string_view())),
+	decltype(std::declval<H &>().onDouble(std::string_view(),double(),std::string_view()))>>: std::true_type {};
+
+// keyword text is opt-in too: a handler with onKeyword gets null, true and false with their type and text
+// instead of onNull and onBool. the text is a view into the input like the other values
+template<typename H, typename = void>
+struct has_keyword_text: std::false_type {};
+
+template<typename H>
+struct has_keyword_text<H,std::void_t<
+	decltype(std::declval<H &>().onKeyword(std::string_view(),ValueType(),std::string_view()))>>: std::true_type {};
+
+// calls the typed event for a number. integral numbers have neither fraction nor exponent
+// notify makes the call, so it can look at the Control the event returns
+template<typename Handler, typename Notify>
+void typedNumberEvent(Handler & handler, std::string_view name, std::string_view value, bool integral, Notify && notify)
+{
+	if( integral ) {
+		bool negative = value[0] == '-';
+		std::uint64_t magnitude;
+		if( numbers::parseDigits(value.substr(negative),magnitude) ) {
+			auto const maxInt64 = std::uint64_t(INT64_MAX);
+			if( ! negative && magnitude <= maxInt64 ) {
+				notify([&] { return handler.onInt64(name,std::int64_t(magnitude),value); });
+				return;
+			}
+			if( ! negative ) {
+				notify([&] { return handler.onUInt64(name,magnitude,value); });
+				return;
+			}
+			if( magnitude <= maxInt64 + 1 ) {
+				notify([&] { return handler.onInt64(name,std::int64_t(0 - magnitude),value); });
+				return;
+			}
+		}
+	}
+	notify([&] { return handler.onDouble(name,numbers::parseDouble(value),value); });
+}
+
+template<typename Handler>
+class BasicParser {
+public:
+	using CharType = char; // TODO template it. type needs to be convertible from char
+	using NameView = std::basic_string_view<CharType>;
+	using ValueView = std::basic_string_view<CharType>;
+	using Engine = json::Engine;
+private:
+	using State = grammar::State;
+	using Action = grammar::Action;
+	using Event = ParserStats::Event;
+	// the buffers of the parser count their allocations in the stats builds
+	template<typename T>
+	using Allocator = std::conditional_t<collectStats,CountingAllocator<T>,std::allocator<T>>;
+	using Buffer = std::basic_string<CharType,std::char_traits<CharType>,Allocator<CharType>>;
+	enum class Status { start, object, array, };
+	enum class NumberPart { beforeDot, afterDot, afterE, };
+	struct Context {
+		Status status;
+		NameView name; // points into the input or into the key set
+		Buffer ownedName; // used when name is empty
+		KeySet::KeyId keyId;
+		NameView objectName() const { return name.empty() ? NameView(ownedName) : name; }
+	};
+	using Contexts = std::stack<Context,std::deque<Context,Allocator<Context>>>;
+	struct IndexedEngine: grammar::TableEngine {};
+
+	Handler handler;
+
+	Contexts contexts;
+	Context context;
+	Path path;
+	KeySet keySet;
+	PathFilter filter;
+	std::size_t deliverDepth; // depth of the subscribed aggregate being delivered or npos
+	struct Skip {
+		std::size_t depth;
+		bool inString;
+		bool escaped;
+		char closer;
+	} skip;
+	static std::size_t const npos = std::size_t(-1);
+	Control pending; // the strongest control returned by the events of the current char
+	bool pausing; // an event asked for pause()
+	std::size_t blockOffset; // bytes consumed before the current block
+	std::size_t stoppedAt;
+	Error err;
+	bool throwing;
+
+	bool isObjectName;
+	// the current token is either the input from tokenStart or, when buffered, the contents of valueStr
+	CharType const * tokenStart;
+	bool buffered;
+	bool stableInput;
+	Buffer valueStr;
+	Buffer unicodeStr;
+	char32_t highSurrogate; // first half of a pair waiting for the second \u escape
+	ValueType keywordType;
+	bool keywordValue;
+	NumberPart numberPart;
+
+	Engine engineType;
+	State state;
+	// the structural index of the current window, used by Engine::indexed
+	std::vector<std::uint32_t,Allocator<std::uint32_t>> stops;
+	std::uint32_t const * nextStop;
+	std::uint32_t const * lastStop;
+	CharType const * indexBase;
+	CharType const * indexEnd;
+	simd::IndexCarry indexCarry;
+	bool indexKept; // resumed inside the current window, whose stops still hold
+	static std::size_t const indexWindow = 64 * 1024;
+	bool feeding;
+	bool inPiece; // parsing a piece of the root array with parseElements()
+	bool rootSkipped; // an event of the piece skipped the rest of the root array
+	bool inLines; // parsing with parseLines()
+	bool isolating;
+	std::vector<Error> failedLines;
+	ParserStats statistics;
+
+	// only offsets are kept while scanning. lines and columns are counted from anchor, a char of the input in hand
+	// whose position is base, when an error or a caller needs them. without an anchor base is where the parse is
+	Position base;
+	CharType const * anchor;
+	CharType const * scanBegin; // the block being scanned, which starts at blockOffset
+	CharType const * scanned; // how far the scans got
+	CharType const * eventChar; // the char that completed the current event
+	std::size_t tokenBegin; // offset of the value being read
+	Span span; // of the current event
+public:
+	explicit BasicParser(Handler handler = Handler()):
+		handler(std::move(handler)),
+		deliverDepth(npos),
+		skip{0,false,false,'}'},
+		pending(Control::proceed),
+		pausing(false),
+		blockOffset(0),
+		stoppedAt(0),
+#ifdef DIE_JSON_EXCEPTIONS
+		throwing(true),
+#else
+		throwing(false),
+#endif
+		tokenStart(nullptr),
+		buffered(false),
+		stableInput(false),
+		highSurrogate(0),
+		engineType(Engine::automaton),
+		state(State::start),
+		nextStop(nullptr),
+		lastStop(nullptr),
+		indexBase(nullptr),
+		indexEnd(nullptr),
+		indexKept(false),
+		feeding(false),
+		inPiece(false),
+		rootSkipped(false),
+		inLines(false),
+		isolating(false),
+		anchor(nullptr),
+		scanBegin(nullptr),
+		scanned(nullptr),
+		eventChar(nullptr),
+		tokenBegin(0),
+		span{0,0}
+	{
+	}
+
+	Handler & getHandler() { return handler; }
+	Handler const & getHandler() const { return handler; }
+
+	BasicParser & engine(Engine engineType) { this->engineType = engineType; return *this; }
+
+	// names found in the key set are not copied and come with their id through currentKeyId()
+	BasicParser & keys(KeySet keySet) { this->keySet = std::move(keySet); return *this; }
+	KeySet const & keys() const { return keySet; }
+
+	// only the events at or below the subscribed paths are delivered
+	// other objects and arrays are skipped by matching brackets and strings, so they are not validated
+	BasicParser & subscribe(PathFilter filter) { this->filter = std::move(filter); return *this; }
+
+	// the stream is read in large blocks straight from its streambuf
+	bool parse(std::basic_istream<CharType> & is)
+	{
+		typename std::basic_istream<CharType>::sentry sentry(is,true);
+		if( ! sentry ) return false;
+
+		StreamSource source(is);
+		return parseSource(source);
+	}
+
+	bool parse(CharType const * data, std::size_t size)
+	{
+		MemorySource source(data,size);
+		return parseSource(source);
+	}
+
+	bool parse(std::basic_string_view<CharType> text) { return parse(text.data(),text.size()); }
+
+	// JSON Lines: every line holds a document of its own and blank lines are skipped
+	// the root start and end events mark the records. lastPosition().line and the error positions are lines of the input
+	bool parseLines(std::basic_istream<CharType> & is)
+	{
+		typename std::basic_istream<CharType>::sentry sentry(is,true);
+		if( ! sentry ) return false;
+
+		StreamSource source(is);
+		return parseLinesSource(source,1);
+	}
+
+	// firstLine numbers the lines of data when it is a piece of a larger input. stopOffset() stays in data
+	bool parseLines(CharType const * data, std::size_t size, int firstLine = 1)
+	{
+		MemorySource source(data,size);
+		return parseLinesSource(source,firstLine);
+	}
+
+	bool parseLines(std::basic_string_view<CharType> text) { return parseLines(text.data(),text.size()); }
+
+	// with isolateLines(true) a line that fails is kept in badLines() and the parse goes on with the next line
+	// nothing is thrown for such lines and only a Control::stop ends the parse early
+	BasicParser & isolateLines(bool isolating) { this->isolating = isolating; return *this; }
+	std::vector<Error> const & badLines() const { return failedLines; }
+
+	// maps the file and parses it in place. views stay valid only during the events
+	bool parseFile(std::string const & path)
+	{
+		MappedFile file(path);
+		if( file.error() ) {
+			reset(true);
+			err = Error{ErrorCode::unreadableFile,base,0,0,{}};
+			return false;
+		}
+		return parse(file.data(),file.size());
+	}
+
+	// push interface: the document is fed in chunks of any size and everything is kept between calls
+	// feed() returns false once the input is rejected and keeps doing it until finish() is called
+	// finish() tells whether the document was complete. the next feed() starts a new document
+	bool feed(CharType const * data, std::size_t size)
+	{
+		if( ! feeding ) {
+			reset(false);
+			feeding = true;
+		}
+		if( state == State::none ) return false;
+
+		Settle settle{*this};
+		auto current = state;
+		state = State::none;	// stays so if the chunk is rejected or an event throws
+		bool accepted = false;
+		switch(engineType) {
+			case Engine::switched:
+				accepted = consume(data,data + size,current,grammar::SwitchedEngine());
+				break;
+			case Engine::automaton:
+				accepted = consume(data,data + size,current,grammar::TableEngine());
+				break;
+			case Engine::indexed:
+				accepted = consume(data,data + size,current,IndexedEngine());
+				break;
+		}
+		if( accepted ) {
+			state = current;
+		}
+		return accepted;
+	}
+
+	bool feed(std::basic_string_view<CharType> chunk) { return feed(chunk.data(),chunk.size()); }
+
+	// parses a piece of the root array cut by splitElements(): whole elements from index first on, each one followed
+	// by its comma, except in the last piece, which runs to the end of the document. start is where the piece begins
+	// the root array has no events of its own. error positions are in the document, stopOffset() is in the piece
+	// an event that skips the rest of the root array ends the piece early: it returns false with skippedRoot() true
+	bool parseElements(CharType const * data, std::size_t size, std::size_t first, Position start, bool last)
+	{
+		reset(true);
+		feeding = false;
+		inPiece = true;
+		// the root array is entered as startArray() does, without its event
+		if( filter.match(path) == PathFilter::Match::full ) {
+			deliverDepth = 0;
+		}
+		changeContext(Status::array);
+		path.pushIndex(first);
+		state = State::startValue;
+		base = start;
+		Settle settle{*this};
+		switch(engineType) {
+			case Engine::switched: return runPiece(grammar::SwitchedEngine(),data,size,last);
+			case Engine::indexed: return runPiece(IndexedEngine(),data,size,last);
+			case Engine::automaton: break;
+		}
+		return runPiece(grammar::TableEngine(),data,size,last);
+	}
+
+	// after parseElements() returned false: the pieces after this one are to be left out
+	// unlike with parse(), what the skip would have matched in them goes unchecked
+	bool skippedRoot() const { return rootSkipped; }
+
+	bool finish()
+	{
+		if( ! feeding ) {
+			reset(false);
+		}
+		feeding = false;
+		return state != State::none && complete(grammar::TableEngine());
+	}
+
+	// after a parse, where it ended: the char of the error or the one after the last char consumed
+	// during an event, the char that completed it
+	Position lastPosition() const
+	{
+		if( err ) return err.pos;
+		return anchor ? positionOf(eventChar) : base;
+	}
+
+	// syntax errors are thrown as the classes of JsonParserExceptions.h by default
+	// with throwErrors(false), or when exceptions are disabled, the parse just returns false and error() tells why
+	BasicParser & throwErrors([[maybe_unused]] bool throwing)
+	{
+#ifdef DIE_JSON_EXCEPTIONS
+		this->throwing = throwing;
+#endif
+		return *this;
+	}
+	// the error that made the last parse return false. also set when nothing was thrown
+	Error const & error() const { return err; }
+
+	// handlers that do not return Control can call request() from inside an event instead
+	void request(Control control)
+	{
+		if( control > pending ) {
+			pending = control;
+		}
+	}
+	bool stopped() const { return pending == Control::stop && ! err; }
+	// byte offset right after the char that completed the stopping or pausing event
+	std::size_t stopOffset() const { return stoppedAt; }
+
+	// pull interface: after an event calls pause(), parse(data,size) returns false right after the char of that event
+	// with paused() true and everything kept. resume() goes on from there with the input from stopOffset() on,
+	// which has to be the same memory. control acts on the paused event as if the event had returned it
+	void pause() { pausing = true; }
+	bool paused() const { return pausing; }
+
+	bool resume(CharType const * rest, std::size_t size, Control control = Control::proceed)
+	{
+		if( ! pausing ) return false;
+		pausing = false;
+		blockOffset = stoppedAt;
+		// the same input goes on, so the window indexed before the pause is walked on instead of indexed again
+		indexKept = engineType == Engine::indexed && indexBase && rest >= indexBase && rest <= indexEnd
+			&& indexEnd <= rest + size;
+		if( ! indexKept ) {
+			indexCarry = simd::IndexCarry(); // events never pause inside a string
+		}
+		if( control == Control::stop ) {
+			pending = Control::stop;
+			return false;
+		}
+		if( control == Control::skip ) {
+			skipRest();
+		}
+		MemorySource source(rest,size);
+		Settle settle{*this};
+		switch(engineType) {
+			case Engine::switched: return run(grammar::SwitchedEngine(),source);
+			case Engine::indexed: return run(IndexedEngine(),source);
+			case Engine::automaton: break;
+		}
+		return run(grammar::TableEngine(),source);
+	}
+
+	// where the current event is. for start and end events it is the location of the aggregate itself
+	// only meaningful during the events
+	Path const & currentPath() const { return path; }
+	// the bytes of the current event in the input, counted like stopOffset(): a bracket, a string with its quotes,
+	// a number or a keyword. only meaningful during the events
+	Span currentSpan() const { return span; }
+	// what stopOffset() would be if the current event stopped the parse. only meaningful during the events
+	std::size_t currentStopOffset() const { return offsetOf(eventChar) + 1; }
+	// the id of the name passed to the current event or KeySet::unknown
+	KeySet::KeyId currentKeyId() const { return context.keyId; }
+
+	// what the parses so far were made of. always zero unless DIE_JSON_STATS is defined
+	ParserStats const & stats() const { return statistics; }
+	ParserStats & stats() { return statistics; }
+private:
+	static std::size_t const bufferSize = 1 << 14;
+
+	// sources hand the input to the parser in contiguous blocks
+
+	class StreamSource {
+		std::basic_istream<CharType> & is;
+		CharType buffer[bufferSize];
+	public:
+		static bool const stable = false; // blocks are overwritten
+		StreamSource(std::basic_istream<CharType> & is): is(is) {}
+
+		bool next(CharType const * & p, CharType const * & end)
+		{
+			auto read = is.rdbuf()->sgetn(buffer,bufferSize);
+			if( read <= 0 ) {
+				is.setstate(std::ios_base::eofbit);
+				return false;
+			}
+			p = buffer;
+			end = buffer + read;
+			return true;
+		}
+	};
+
+	class MemorySource {
+		CharType const * data;
+		CharType const * dataEnd;
+	public:
+		static bool const stable = true;
+		MemorySource(CharType const * data, std::size_t size): data(data), dataEnd(data + size) {}
+
+		bool next(CharType const * & p, CharType const * & end)
+		{
+			if( data == dataEnd ) return false;
+			p = data;
+			end = data = dataEnd;
+			return true;
+		}
+	};
+
+	void reset(bool stableInput)
+	{
+		if( ! contexts.empty() ) {
+			Contexts().swap(contexts);  // really? no .clear()? no rvalue swap() either?
+		}
+		context.status = Status::start;
+		context.name = NameView();	// a stopped or failed parse leaves its context behind
+		context.ownedName.clear();
+		context.keyId = KeySet::unknown;
+		isObjectName = false;
+		path.clear();
+		deliverDepth = npos;
+		skip = Skip{0,false,false,'}'};
+		pending = Control::proceed;
+		pausing = false;
+		blockOffset = 0;
+		stoppedAt = 0;
+		err = Error();
+		state = State::start;
+		indexCarry = simd::IndexCarry();
+		indexKept = false;
+		inPiece = false;
+		rootSkipped = false;
+		inLines = false;
+		tokenStart = nullptr;
+		this->stableInput = stableInput;
+		base = Position{1,1};
+		anchor = nullptr;
+	}
+
+	// the input is gone once a parse returns, so its position is counted before that. also when an event throws
+	struct Settle {
+		BasicParser & parser;
+		~Settle() { parser.settle(); }
+	};
+
+	void settle()
+	{
+		base = here();
+		anchor = nullptr;
+	}
+
+	// counts the lines from the anchor. p is in the same input
+	Position positionOf(CharType const * p) const
+	{
+		if( ! anchor ) return base;
+		auto lines = simd::countLines(anchor,p);
+		if( lines.count == 0 ) return Position{base.column + int(p - anchor),base.line};
+		return Position{int(p - lines.lastStart) + 1,base.line + int(lines.count)};
+	}
+
+	Position here() const { return positionOf(scanned); }
+
+	std::size_t offsetOf(CharType const * p) const { return blockOffset + (p - scanBegin); }
+
+	template<typename Source>
+	bool parseSource(Source & source)
+	{
+		reset(Source::stable);
+		feeding = false;
+		Settle settle{*this};
+		switch(engineType) {
+			case Engine::switched: return run(grammar::SwitchedEngine(),source);
+			case Engine::indexed: return run(IndexedEngine(),source);
+			case Engine::automaton: break;
+		}
+		return run(grammar::TableEngine(),source);
+	}
+
+	template<typename Source>
+	bool parseLinesSource(Source & source, int firstLine)
+	{
+		reset(Source::stable);
+		feeding = false;
+		inLines = true;
+		failedLines.clear();
+		base.line = firstLine;
+		Settle settle{*this};
+		switch(engineType) {
+			case Engine::switched: return runLines(grammar::SwitchedEngine(),source);
+			case Engine::indexed: return runLines(IndexedEngine(),source);
+			case Engine::automaton: break;
+		}
+		return runLines(grammar::TableEngine(),source);
+	}
+
+	// each line goes through consume() on its own, so a document never runs into the next one
+	template<typename E, typename Source>
+	bool runLines(E const & engine, Source & source)
+	{
+		CharType const * p;
+		CharType const * end;
+		std::size_t offset = 0; // of the current block
+		bool badLine = false; // the rest of a failed line is ignored
+		while( source.next(p,end) ) {
+			auto block = p;
+			while( p != end ) {
+				auto newline = static_cast<CharType const *>(std::memchr(p,'\n',end - p));
+				auto lineEnd = newline ? newline : end;
+				if( ! badLine && ! consume(p,lineEnd,state,engine) ) {
+					if( ! lineFailed() ) return false;
+					badLine = true;
+				}
+				if( ! newline ) break;
+				if( ! badLine && ! endLine(engine) && ! lineFailed() ) return false;
+				badLine = false;
+				nextLine(offset + (newline + 1 - block));
+				p = newline + 1;
+			}
+			offset += end - block;
+		}
+		return badLine || endLine(engine) || lineFailed();
+	}
+
+	// blank lines have no document
+	template<typename E>
+	bool endLine(E const & engine) { return state == State::start || complete(engine); }
+
+	bool lineFailed()
+	{
+		if( ! isolating || stopped() ) return false;
+		failedLines.push_back(err);
+		return true;
+	}
+
+	// every record starts from scratch, so nothing a line left open reaches the next one
+	void nextLine(std::size_t offset)
+	{
+		auto line = base.line + 1; // lines have no newline inside, so base stays on the line
+		reset(stableInput);
+		inLines = true;
+		base = Position{1,line};
+		anchor = nullptr; // the next line is anchored where its scan starts
+		blockOffset = offset;
+	}
+
+	template<typename E, typename Source>
+	bool run(E const & engine, Source & source)
+	{
+		CharType const * p;
+		CharType const * end;
+		while( source.next(p,end) ) {
+			if( ! consume(p,end,state,engine) ) return false;
+		}
+		return complete(engine);
+	}
+
+	template<typename E>
+	bool runPiece(E const & engine, CharType const * data, std::size_t size, bool last)
+	{
+		if( ! consume(data,data + size,state,engine) ) return false;
+		if( last ) return complete(engine);
+		if( skip.depth && contexts.empty() ) {
+			// the rest of the root array was skipped. the pieces after this one cannot honor that
+			rootSkipped = true;
+			return false;
+		}
+		// the other pieces end right after a comma of the root array
+		if( state == State::startValue && contexts.size() == 1 ) return true;
+		return complete(engine);
+	}
+
+	template<typename E>
+	bool consume(CharType const * p, CharType const * end, State & state, E const & engine)
+	{
+		if constexpr( collectStats ) {
+			StatsScope scope(*this);
+			return consumeBlock(p,end,state,engine);
+		} else {
+			return consumeBlock(p,end,state,engine);
+		}
+	}
+
+	// times a consume() and counts the allocations of the buffers meanwhile. the events time themselves
+	class StatsScope {
+		ParserStats & stats;
+		std::chrono::steady_clock::time_point start;
+		std::chrono::nanoseconds callbacks;
+		std::uint64_t * outerCounter;
+	public:
+		explicit StatsScope(BasicParser & parser):
+			stats(parser.statistics),
+			start(std::chrono::steady_clock::now()),
+			callbacks(stats.callbackTime),
+			outerCounter(allocationCounter)
+		{
+			allocationCounter = &stats.allocations;
+		}
+
+		~StatsScope()
+		{
+			allocationCounter = outerCounter;
+			stats.parserTime += std::chrono::steady_clock::now() - start - (stats.callbackTime - callbacks);
+		}
+	};
+
+	template<typename E>
+	bool consumeBlock(CharType const * p, CharType const * end, State & state, E const & engine)
+	{
+		return scan(p,end,state,engine);
+	}
+
+	bool consumeBlock(CharType const * p, CharType const * end, State & state, grammar::SwitchedEngine const & engine)
+	{
+		return scanSwitched(p,end,state,engine);
+	}
+
+	// two stage parsing: each window is indexed first, then the switch of Engine::switched walks its stops
+	// whitespace is jumped over to the next stop and strings and skipped subtrees are crossed from stop to stop
+	bool consumeBlock(CharType const * p, CharType const * end, State & state, IndexedEngine const & engine)
+	{
+		if( indexKept ) {
+			indexKept = false;
+			if( ! scanSwitched(p,indexEnd,state,engine) ) return false;
+			p = indexEnd;
+		}
+		while( p != end ) {
+			auto windowEnd = std::size_t(end - p) > indexWindow ? p + indexWindow : end;
+			stops.resize(indexWindow + simd::indexSlack);
+			indexBase = p;
+			indexEnd = windowEnd;
+			nextStop = stops.data();
+			lastStop = simd::buildIndex(p,p,windowEnd,indexCarry,stops.data());
+			if( ! scanSwitched(p,windowEnd,state,engine) ) return false;
+			p = windowEnd;
+		}
+		return true;
+	}
+
+	template<typename E>
+	bool scan(CharType const * p, CharType const * end, State & state, E const & engine)
+	{
+		auto begin = p;
+		startScan(begin);
+		while( p != end ) {
+			if( skip.depth ) {
+				p = skipSubtree(p,end,state,engine);
+				if( p == end ) break;
+			}
+			switch(state) {
+				case State::stringValue:
+					p = scanString(p,end,engine);
+					break;
+				case State::start:
+				case State::startObject:
+				case State::startValue:
+				case State::endValue:
+				case State::endAggregate:
+					if( grammar::isSpace(*p) ) {
+						p = simd::skipWhitespace(p,end);
+					}
+					break;
+				default:
+					break;
+			}
+			if( p == end ) break;
+
+			auto ch = *p;
+			auto step = engine.transit(state,ch);
+			if constexpr( collectStats ) {
+				++statistics.transitions[std::size_t(state)];
+			}
+			if( step.next == State::none ) return reject(p,begin,state);
+
+			auto proceed = doAction(step.action,p);
+			state = step.next;
+			++p;
+			if( ! proceed && halt(p,begin) ) return false;
+		}
+		return endScan(begin,end);
+	}
+
+	// Engine::switched and the stage 2 of Engine::indexed: one switch over the state that does the actions right there,
+	// with no table and no action codes. digits, keywords, strings and whitespace are taken whole. the rare chars go one by one through
+	// grammar::SwitchedEngine and doAction(), so events and errors are the same as the automaton's
+	template<typename E>
+	bool scanSwitched(CharType const * p, CharType const * end, State & state, E const & engine)
+	{
+		auto begin = p;
+		startScan(begin);
+		while( p != end ) {
+			if( skip.depth ) {
+				p = skipSubtree(p,end,state,engine);
+				if( p == end ) break;
+			}
+			auto ch = *p;
+			auto const from = state;
+			bool proceed = true;
+			switch(state) {
+				case State::start:
+					switch(ch) {
+						case ' ': case '\t': case '\n': case '\r':
+							p = skipSpace(p,end,engine);
+							continue;
+						case '{':
+							state = State::startObject;
+							startObject(p);
+							proceed = going();
+							break;
+						case '[':
+							state = State::startValue;
+							startArray(p);
+							proceed = going();
+							break;
+						default:
+							return reject(p,begin,state);
+					}
+					break;
+				case State::startObject:
+					switch(ch) {
+						case ' ': case '\t': case '\n': case '\r':
+							p = skipSpace(p,end,engine);
+							continue;
+						case '"':
+							state = State::stringValue;
+							isObjectName = true;
+							beginToken(p+1);
+							break;
+						case '}':
+							state = State::endAggregate;
+							endObject(p);
+							proceed = going();
+							break;
+						default:
+							return reject(p,begin,state);
+					}
+					break;
+				case State::startValue:
+					switch(ch) {
+						case ' ': case '\t': case '\n': case '\r':
+							p = skipSpace(p,end,engine);
+							continue;
+						case '"':
+							state = State::stringValue;
+							startString(p);
+							break;
+						case '{':
+							state = State::startObject;
+							startObject(p);
+							proceed = going();
+							break;
+						case '[':
+							startArray(p);
+							proceed = going();
+							break;
+						case ']':
+							state = State::endAggregate;
+							endArray(p);
+							proceed = going();
+							break;
+						case '-':
+							state = State::negativeNumber;
+							beginNumber(p);
+							break;
+						case '0':
+							state = State::startFractionalNumber;
+							beginNumber(p);
+							break;
+						case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+							state = State::numberValue;
+							beginNumber(p);
+							break;
+						case 'n':
+							startKeyword(p,ValueType::null,false);
+							if( wholeKeyword(p,end,"null") ) {
+								p += 3;
+								state = State::endValue;
+								proceed = emitKeyword(p);
+							} else {
+								state = State::nullValue_ull;
+							}
+							break;
+						case 't':
+							startKeyword(p,ValueType::boolean,true);
+							if( wholeKeyword(p,end,"true") ) {
+								p += 3;
+								state = State::endValue;
+								proceed = emitKeyword(p);
+							} else {
+								state = State::trueValue_rue;
+							}
+							break;
+						case 'f':
+							startKeyword(p,ValueType::boolean,false);
+							if( wholeKeyword(p,end,"false") ) {
+								p += 4;
+								state = State::endValue;
+								proceed = emitKeyword(p);
+							} else {
+								state = State::falseValue_alse;
+							}
+							break;
+						default:
+							return reject(p,begin,state);
+					}
+					break;
+				case State::endValue:
+					switch(ch) {
+						case ' ': case '\t': case '\n': case '\r':
+							p = skipSpace(p,end,engine);
+							continue;
+						case ',':
+							if( isObjectName ) {
+								proceed = fail(ErrorCode::expectedChar,p,':');
+								break;
+							}
+							state = State::startValue;
+							startValue();
+							break;
+						case ':':
+							if( ! isObjectName ) {
+								proceed = fail(ErrorCode::unexpectedChar,p);
+								break;
+							}
+							state = State::startValue;
+							isObjectName = false;
+							break;
+						case '}':
+							state = State::endAggregate;
+							endObject(p);
+							proceed = going();
+							break;
+						case ']':
+							state = State::endAggregate;
+							endArray(p);
+							proceed = going();
+							break;
+						default:
+							return reject(p,begin,state);
+					}
+					break;
+				case State::endAggregate:
+					switch(ch) {
+						case ' ': case '\t': case '\n': case '\r':
+							p = skipSpace(p,end,engine);
+							continue;
+						case ',':
+							if( context.status == Status::start ) {
+								proceed = fail(ErrorCode::unexpectedChar,p);
+								break;
+							}
+							state = State::startValue;
+							startValue();
+							break;
+						case '}':
+							endObject(p);
+							proceed = going();
+							break;
+						case ']':
+							endArray(p);
+							proceed = going();
+							break;
+						default:
+							return reject(p,begin,state);
+					}
+					break;
+				case State::stringValue:
+					p = scanString(p,end,engine);
+					if( p == end ) continue;
+					if( *p != '"' ) {
+						auto next = grammar::SwitchedEngine().transit(state,*p);
+						if( next.next == State::none ) return reject(p,begin,state);
+						state = next.next;
+						proceed = doAction(next.action,p);
+						break;
+					}
+					state = State::endValue;
+					proceed = endString(p);
+					break;
+				case State::numberValue:
+					switch(ch) {
+						case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9': {
+							auto q = p + 1;
+							while( q != end && grammar::isDigit(*q) ) {
+								++q;
+							}
+							if( buffered ) {
+								valueStr.append(p,q);
+							}
+							p = q;
+							continue;
+						}
+						case ' ': case '\t': case '\n': case '\r':
+							state = State::endValue;
+							emitNumber(p);
+							proceed = going();
+							break;
+						case ',':
+							state = State::startValue;
+							emitNumber(p);
+							startValue();
+							proceed = going();
+							break;
+						case '}':
+							state = State::endAggregate;
+							emitNumber(p);
+							endObject(p);
+							proceed = going();
+							break;
+						case ']':
+							state = State::endAggregate;
+							emitNumber(p);
+							endArray(p);
+							proceed = going();
+							break;
+						default: {
+							auto next = grammar::SwitchedEngine().transit(state,ch);
+							if( next.next == State::none ) return reject(p,begin,state);
+							state = next.next;
+							proceed = doAction(next.action,p);
+						}
+					}
+					break;
+				default: {
+					auto next = grammar::SwitchedEngine().transit(state,ch);
+					if( next.next == State::none ) return reject(p,begin,state);
+					state = next.next;
+					proceed = doAction(next.action,p);
+				}
+			}
+			if constexpr( collectStats ) {
+				++statistics.transitions[std::size_t(from)];
+			}
+			++p;
+			if( ! proceed && halt(p,begin) ) return false;
+		}
+		return endScan(begin,end);
+	}
+
+	template<typename E>
+	CharType const * skipSpace(CharType const * p, CharType const * end, E const &)
+	{
+		return simd::skipWhitespace(p,end);
+	}
+
+	// outside strings, the first char after whitespace that is not whitespace is the next stop
+	CharType const * skipSpace(CharType const * p, CharType const * end, IndexedEngine const &)
+	{
+		return stopFrom(p,end);
+	}
+
+	static bool wholeKeyword(CharType const * p, CharType const * end, std::string_view word)
+	{
+		return std::size_t(end - p) >= word.size() && std::memcmp(p,word.data(),word.size()) == 0;
+	}
+
+	void startScan(CharType const * begin)
+	{
+		scanBegin = begin;
+		scanned = begin;
+		if( ! anchor ) {
+			anchor = begin;
+		}
+	}
+
+	// the block was scanned to its end
+	bool endScan(CharType const * begin, CharType const * end)
+	{
+		scanned = end;
+		consumed(end - begin);
+		if( err ) return false; // found by a fast path
+		// the block is going away, so the current token needs its own copy and its lines are counted
+		if( ! stableInput ) {
+			if( tokenStart ) {
+				bufferToken(end);
+			}
+			settle();
+		}
+		blockOffset += end - begin;
+		return true;
+	}
+
+	bool reject(CharType const * p, CharType const * begin, State state)
+	{
+		err = Error{ErrorCode::rejectedChar,positionOf(p),char(*p),0,grammar::acceptedChars(state)};
+		scanned = p;
+		consumed(p - begin);
+		return false;
+	}
+
+	// after an action that did not return true. tells whether the scan ends right after its char at p
+	bool halt(CharType const * p, CharType const * begin)
+	{
+		if( pending == Control::skip ) {
+			pending = Control::proceed;
+			skipRest();
+		}
+		if( pending != Control::stop && ! pausing ) return false;
+		stoppedAt = blockOffset + (p - begin);
+		scanned = p;
+		consumed(p - begin);
+		return true;
+	}
+
+	void consumed(std::size_t size)
+	{
+		if constexpr( collectStats ) {
+			statistics.bytes += size;
+		}
+	}
+
+	void valueLength(std::size_t size)
+	{
+		if constexpr( collectStats ) {
+			statistics.longestValue = std::max(statistics.longestValue,size);
+		}
+	}
+
+	// string fast path: appends whole runs of plain chars and decodes complete escape sequences in place
+	// stops at the closing quote, at the end of the block or at anything the automaton must judge
+	template<typename E>
+	CharType const * scanString(CharType const * p, CharType const * end, E const & engine)
+	{
+		for(;;) {
+			auto q = findQuoteOrEscape(p,end,engine);
+			if( highSurrogate && q != p ) {
+				fail(ErrorCode::loneSurrogate,p);
+				return end;
+			}
+			if( buffered ) {
+				valueStr.append(p,q);
+			}
+			p = q;
+			if( p == end || *p == '"' || end - p < 2 ) return p;
+
+			auto escaped = grammar::escapedChar(p[1]);
+			if( escaped != 0 ) {
+				if( highSurrogate ) {
+					fail(ErrorCode::loneSurrogate,p + 1);
+					return end;
+				}
+				bufferToken(p);
+				valueStr.push_back(escaped);
+				p += 2;
+			} else if( p[1] == 'u' && end - p >= 6 && std::all_of(p+2,p+6,grammar::isHex) ) {
+				bufferToken(p);
+				if( ! addUnicode(grammar::hexCode(p+2),p + 5) ) return end;
+				p += 6;
+			} else {
+				return p;
+			}
+		}
+	}
+
+	// walks a subtree nobody subscribed to until its closing bracket. only brackets and string boundaries are tracked
+	template<typename E>
+	CharType const * skipSubtree(CharType const * p, CharType const * end, State & state, E const & engine)
+	{
+		while( p != end ) {
+			if( skip.inString ) {
+				if( skip.escaped ) {
+					skip.escaped = false;
+					++p;
+					continue;
+				}
+				p = findQuoteOrEscape(p,end,engine);
+				if( p == end ) break;
+				skip.escaped = *p == '\\';
+				skip.inString = skip.escaped;
+				++p;
+				continue;
+			}
+			p = findQuoteOrBracket(p,end,engine);
+			if( p == end ) break;
+			switch(*p) {
+				case '"':
+					skip.inString = true;
+					break;
+				case '{':
+				case '[':
+					++skip.depth;
+					break;
+				default:
+					if( --skip.depth == 0 ) {
+						if( *p != skip.closer ) {
+							fail(*p == '}' ? ErrorCode::unexpectedObjectClosing : ErrorCode::unexpectedArrayClosing,p);
+							return end;
+						}
+						state = State::endAggregate;
+						return p + 1;
+					}
+			}
+			++p;
+		}
+		return p;
+	}
+
+	template<typename E>
+	CharType const * findQuoteOrEscape(CharType const * p, CharType const * end, E const &)
+	{
+		return simd::findQuoteOrEscape(p,end);
+	}
+
+	template<typename E>
+	CharType const * findQuoteOrBracket(CharType const * p, CharType const * end, E const &)
+	{
+		return simd::findQuoteOrBracket(p,end);
+	}
+
+	// inside a string the stops are the closing quote and the escapes
+	CharType const * findQuoteOrEscape(CharType const * p, CharType const * end, IndexedEngine const &)
+	{
+		return stopFrom(p,end);
+	}
+
+	// outside strings the stops are quotes, operators and the starts of numbers and keywords
+	CharType const * findQuoteOrBracket(CharType const * p, CharType const * end, IndexedEngine const &)
+	{
+		for(;;) {
+			p = stopFrom(p,end);
+			if( p == end ) return p;
+			switch(*p) {
+				case '"': case '{': case '}': case '[': case ']':
+					return p;
+			}
+			++p;
+		}
+	}
+
+	// the first stop of the index at or after p. the fast paths only move forward, so neither does the cursor
+	CharType const * stopFrom(CharType const * p, CharType const * end)
+	{
+		auto offset = std::uint32_t(p - indexBase);
+		while( nextStop != lastStop && *nextStop < offset ) {
+			++nextStop;
+		}
+		return nextStop == lastStop ? end : indexBase + *nextStop;
+	}
+
+	// returns false when an event or an error asks the parse to skip or stop
+	// the actions that cannot do either return true right away, so the common chars do not look at pending
+	bool doAction(Action action, CharType const * p)
+	{
+		auto ch = *p;
+		switch(action) {
+			case Action::none:
+				return true;
+			case Action::startObject:
+				startObject(p);
+				break;
+			case Action::endObject:
+				endObject(p);
+				break;
+			case Action::startArray:
+				startArray(p);
+				break;
+			case Action::endArray:
+				endArray(p);
+				break;
+			case Action::startObjectName:
+				isObjectName = true;
+				beginToken(p+1);
+				return true;
+			case Action::startString:
+				startString(p);
+				return true;
+			case Action::endString:
+				return endString(p);
+			case Action::addValue:
+				if( highSurrogate ) return fail(ErrorCode::loneSurrogate,p);
+				addValue(ch);
+				return true;
+			case Action::startEscape:
+				bufferToken(p);
+				return true;
+			case Action::addEscaped:
+				if( highSurrogate ) return fail(ErrorCode::loneSurrogate,p);
+				addValue(grammar::escapedChar(ch));
+				return true;
+			case Action::startUnicode:
+				unicodeStr.clear();
+				return true;
+			case Action::addUnicode:
+				unicodeStr.push_back(ch);
+				return true;
+			case Action::endUnicode:
+				unicodeStr.push_back(ch);
+				return addUnicode(grammar::hexCode(unicodeStr.data()),p);
+			case Action::beginNumber:
+				beginNumber(p);
+				return true;
+			case Action::startNumber:
+				addValue(ch);
+				numberPart = NumberPart::beforeDot;
+				return true;
+			case Action::startDot:
+				addValue(ch);
+				numberPart = NumberPart::afterDot;
+				return true;
+			case Action::numberDot:
+				if( numberPart >= NumberPart::afterDot ) return fail(ErrorCode::unexpectedChar,p);
+				addValue(ch);
+				numberPart = NumberPart::afterDot;
+				return true;
+			case Action::numberE:
+				if( numberPart >= NumberPart::afterE ) return fail(ErrorCode::unexpectedChar,p);
+				addValue(ch);
+				numberPart = NumberPart::afterE;
+				return true;
+			case Action::emitNumber:
+				emitNumber(p);
+				break;
+			case Action::emitNumberAndClear:
+				emitNumber(p);
+				startValue();
+				break;
+			case Action::emitNumberAndEndObject:
+				emitNumber(p);
+				endObject(p);
+				break;
+			case Action::emitNumberAndEndArray:
+				emitNumber(p);
+				endArray(p);
+				break;
+			case Action::newNull:
+				startKeyword(p,ValueType::null,false);
+				return true;
+			case Action::newBoolean:
+				startKeyword(p,ValueType::boolean,ch == 't');
+				return true;
+			case Action::addAndEmitKeyword:
+				return emitKeyword(p);
+			case Action::endObjectName:
+				if( ! isObjectName ) return fail(ErrorCode::unexpectedChar,p);
+				isObjectName = false;
+				return true;
+			case Action::nextValue:
+				if( isObjectName ) return fail(ErrorCode::expectedChar,p,':');
+				startValue();
+				return true;
+			case Action::nextAggregate:
+				if( context.status == Status::start ) return fail(ErrorCode::unexpectedChar,p);
+				startValue();
+				return true;
+		}
+		return going();
+	}
+
+	bool going() const { return pending == Control::proceed && ! pausing; }
+
+	// aux dumb functions
+
+	void startString(CharType const * p)
+	{
+		beginToken(p+1);
+		tokenBegin = offsetOf(p);
+	}
+
+	bool endString(CharType const * p)
+	{
+		if( highSurrogate ) return fail(ErrorCode::loneSurrogate,p);
+		auto value = tokenValue(p);
+		tokenStart = nullptr;
+		valueLength(value.size());
+		if( isObjectName ) {
+			if( value.empty() ) return fail(ErrorCode::emptyObjectName,p);
+			setObjectName(value);
+			return true;
+		}
+		if( wanted() ) {
+			eventAt(p,offsetOf(p) + 1);
+			notify(Event::string,[&] { return handler.onString(context.objectName(),value); });
+		}
+		return going();
+	}
+
+	void beginNumber(CharType const * p)
+	{
+		beginToken(p);
+		tokenBegin = offsetOf(p);
+		numberPart = NumberPart::beforeDot;
+	}
+
+	void startKeyword(CharType const * p, ValueType type, bool value)
+	{
+		keywordType = type;
+		keywordValue = value;
+		beginToken(p);
+		tokenBegin = offsetOf(p);
+	}
+
+	// p is the last letter
+	bool emitKeyword(CharType const * p)
+	{
+		auto start = tokenStart;
+		tokenStart = nullptr;
+		if( ! wanted() ) return true;
+		eventAt(p,offsetOf(p) + 1);
+		if constexpr( has_keyword_text<Handler>::value ) {
+			// only the first letters of a keyword cut by the end of a stream block were kept
+			auto text = buffered ? keywordText() : ValueView(start,p + 1 - start);
+			auto event = keywordType == ValueType::null ? Event::null : Event::boolean;
+			notify(event,[&] { return handler.onKeyword(context.objectName(),keywordType,text); });
+		} else if( keywordType == ValueType::null ) {
+			notify(Event::null,[&] { return handler.onNull(context.objectName()); });
+		} else {
+			notify(Event::boolean,[&] { return handler.onBool(context.objectName(),keywordValue); });
+		}
+		return going();
+	}
+
+	ValueView keywordText() const
+	{
+		if( keywordType == ValueType::null ) return "null";
+		return keywordValue ? "true" : "false";
+	}
+
+	void startObject(CharType const * p)
+	{
+		tokenBegin = offsetOf(p);
+		eventAt(p,tokenBegin + 1);
+		switch(enterAggregate('}')) {
+			case PathFilter::Match::none: return;
+			case PathFilter::Match::prefix: break;
+			case PathFilter::Match::full: notify(Event::startObject,[&] { return handler.onStartObject(context.objectName()); }); break;
+		}
+		changeContext(Status::object);
+		path.pushKey();
+	}
+
+	void endObject(CharType const * p)
+	{
+		if( context.status != Status::object ) {
+			fail(ErrorCode::unexpectedObjectClosing,p);
+			return;
+		}
+		tokenBegin = offsetOf(p);
+		eventAt(p,tokenBegin + 1);
+		popContext();
+		path.pop();
+		if( pending == Control::skip ) {
+			pending = Control::proceed; // the skipped object ends right here
+		} else if( delivering() ) {
+			notify(Event::endObject,[&] { return handler.onEndObject(context.objectName()); });
+		}
+		leaveAggregate();
+	}
+
+	void startArray(CharType const * p)
+	{
+		tokenBegin = offsetOf(p);
+		eventAt(p,tokenBegin + 1);
+		switch(enterAggregate(']')) {
+			case PathFilter::Match::none: return;
+			case PathFilter::Match::prefix: break;
+			case PathFilter::Match::full: notify(Event::startArray,[&] { return handler.onStartArray(context.objectName()); }); break;
+		}
+		changeContext(Status::array);
+		path.pushIndex();
+	}
+
+	void endArray(CharType const * p)
+	{
+		if( context.status != Status::array ) {
+			fail(ErrorCode::unexpectedArrayClosing,p);
+			return;
+		}
+		tokenBegin = offsetOf(p);
+		eventAt(p,tokenBegin + 1);
+		popContext();
+		path.pop();
+		if( pending == Control::skip ) {
+			pending = Control::proceed; // the skipped array ends right here
+		} else if( delivering() && ! (inPiece && contexts.empty()) ) {
+			notify(Event::endArray,[&] { return handler.onEndArray(context.objectName()); });
+		}
+		leaveAggregate();
+	}
+
+	// every syntax error goes through here, with the offending char. the parse ends after the current char
+	bool fail(ErrorCode code, CharType const * at, char expected = 0)
+	{
+		err = Error{code,positionOf(at),char(*at),expected,{}};
+		pending = Control::stop;
+#ifdef DIE_JSON_EXCEPTIONS
+		if( throwing && ! (inLines && isolating) ) raise(err);
+#endif
+		return false;
+	}
+
+	template<typename E>
+	bool complete(E const & engine)
+	{
+		// after a nested aggregate the state is final too, so the root has to be closed as well
+		if( engine.final(state) && contexts.empty() ) return true;
+		if( ! err ) {
+			err = Error{ErrorCode::incomplete,here(),0,0,{}};
+		}
+		return false;
+	}
+
+	template<typename Call>
+	void notify(Event event, Call && call)
+	{
+		if( pending == Control::stop ) return;
+		if constexpr( collectStats ) {
+			++statistics.events[std::size_t(event)];
+			auto start = std::chrono::steady_clock::now();
+			deliver(call);
+			statistics.callbackTime += std::chrono::steady_clock::now() - start;
+		} else {
+			deliver(call);
+		}
+	}
+
+	template<typename Call>
+	void deliver(Call && call)
+	{
+		if constexpr( std::is_void_v<decltype(call())> ) {
+			call();
+		} else {
+			request(call());
+		}
+	}
+
+	// leaves the innermost open aggregate without its end event and skips what is left of it
+	void skipRest()
+	{
+		if( context.status == Status::start ) return;
+		auto closer = context.status == Status::object ? '}' : ']';
+		popContext();
+		path.pop();
+		leaveAggregate();
+		isObjectName = false;
+		skip = Skip{1,false,false,closer};
+	}
+
+	// subscriptions. prefix aggregates are walked without events and the others are skipped
+
+	bool delivering() const { return filter.empty() || deliverDepth != npos; }
+	bool wanted() const { return delivering() || filter.match(path) == PathFilter::Match::full; }
+
+	PathFilter::Match enterAggregate(char closer)
+	{
+		if( delivering() ) return PathFilter::Match::full;
+		auto match = filter.match(path);
+		if( match == PathFilter::Match::full ) {
+			deliverDepth = path.depth();
+		} else if( match == PathFilter::Match::none ) {
+			skip = Skip{1,false,false,closer};
+		}
+		return match;
+	}
+
+	void leaveAggregate()
+	{
+		if( deliverDepth == path.depth() ) {
+			deliverDepth = npos;
+		}
+	}
+
+	void changeContext(Status newStatus)
+	{
+		contexts.push(context);
+		if constexpr( collectStats ) {
+			statistics.maxDepth = std::max(statistics.maxDepth,contexts.size());
+		}
+		context.status = newStatus;
+		if( newStatus != Status::array ) {
+			context.name = NameView();
+			context.ownedName.clear();
+			context.keyId = KeySet::unknown;
+		}
+	}
+
+	// object and array contexts always have their parent below them
+	void popContext()
+	{
+		context = contexts.top();
+		contexts.pop();
+	}
+
+	// names are kept as views only while the input stays around
+	void setObjectName(NameView name)
+	{
+		auto keyId = keySet.find(name);
+		context.keyId = keyId;
+		if( keyId != KeySet::unknown ) {
+			context.name = keySet.key(keyId);
+			context.ownedName.clear();
+			path.setKey(context.name,keyId,true);
+		} else if( stableInput && ! buffered ) {
+			context.name = name;
+			context.ownedName.clear();
+			path.setKey(name,keyId,true);
+		} else {
+			path.setKey(name,keyId,false);
+			context.name = NameView();
+			context.ownedName.assign(name.data(),name.size());
+		}
+	}
+
+	void emitNumber(CharType const * end)
+	{
+		auto value = tokenValue(end);
+		tokenStart = nullptr;
+		valueLength(value.size());
+		if( ! wanted() ) return;
+		eventAt(end,offsetOf(end));
+		if constexpr( has_typed_numbers<Handler>::value ) {
+			emitTypedNumber(value);
+		} else {
+			notify(Event::number,[&] { return handler.onNumber(context.objectName(),value); });
+		}
+	}
+
+	void emitTypedNumber(ValueView value)
+	{
+		typedNumberEvent(handler,context.objectName(),value,numberPart == NumberPart::beforeDot,
+			[this](auto && call) { notify(Event::number,call); });
+	}
+
+	void startValue()
+	{
+		if( context.status == Status::object ) {
+			isObjectName = true;
+		} else if( context.status == Status::array ) {
+			path.nextIndex();
+		}
+	}
+
+	// the next event is completed by the char at p and its token ends at offset end
+	void eventAt(CharType const * p, std::size_t end)
+	{
+		eventChar = p;
+		span = Span{tokenBegin,end - tokenBegin};
+	}
+
+	void beginToken(CharType const * p)
+	{
+		tokenStart = p;
+		buffered = false;
+		highSurrogate = 0;
+	}
+
+	// pairs up surrogates. at is the last hex digit, reported if the pair is broken
+	bool addUnicode(char32_t code, CharType const * at)
+	{
+		bool high = code >= 0xD800 && code <= 0xDBFF;
+		bool low = code >= 0xDC00 && code <= 0xDFFF;
+		if( highSurrogate ) {
+			if( ! low ) return fail(ErrorCode::loneSurrogate,at);
+			code = 0x10000 + ((highSurrogate - 0xD800) << 10) + (code - 0xDC00);
+			highSurrogate = 0;
+		} else if( high ) {
+			highSurrogate = code;
+			return true;
+		} else if( low ) {
+			return fail(ErrorCode::loneSurrogate,at);
+		}
+		CharTraits<CharType>::appendCodePoint(valueStr,code);
+		return true;
+	}
+
+	// copies the token read so far to valueStr, so chars that are not in the input can be added
+	void bufferToken(CharType const * end)
+	{
+		if( ! buffered ) {
+			valueStr.assign(tokenStart,end);
+			buffered = true;
+		}
+	}
+
+	ValueView tokenValue(CharType const * end) const
+	{
+		return buffered ? ValueView(valueStr) : ValueView(tokenStart,end - tokenStart);
+	}
+
+	void addValue(char ch)
+	{
+		if( buffered ) {
+			valueStr.push_back(ch);
+		}
+	}
+};
+
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONBASICPARSER_H_ */
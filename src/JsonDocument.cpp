@@ -0,0 +1,166 @@
+#include "JsonDocument.h"
+
+namespace die {
+namespace json {
+
+bool Document::parse(std::string_view text)
+{
+	clear();
+	return finish(parser.parse(text));
+}
+
+bool Document::parse(std::istream & is)
+{
+	clear();
+	return finish(parser.parse(is));
+}
+
+bool Document::parseFile(std::string const & path)
+{
+	clear();
+	return finish(parser.parseFile(path));
+}
+
+bool Document::finish(bool parsed)
+{
+	complete = parsed && ! tape().empty();
+	if( ! parsed ) clear();
+	return parsed;
+}
+
+void Document::clear()
+{
+	// the memory stays for the next parse
+	auto & builder = parser.getHandler();
+	builder.tape.clear();
+	builder.chars.clear();
+	builder.open.clear();
+	complete = false;
+}
+
+Document::Value Document::root() const
+{
+	return complete ? Value(this,0) : Value();
+}
+
+std::size_t Document::next(std::size_t at) const
+{
+	switch(tag(at)) {
+		case '{': case '[': return payload(at) + 1;
+		case 'l': case 'u': case 'd': return at + 2;
+	}
+	return at + 1;
+}
+
+std::string_view Document::string(std::size_t at) const
+{
+	auto const & chars = parser.getHandler().chars;
+	auto offset = std::size_t(tape()[at] & 0xFFFFFFFFFFFFFFull);
+	std::uint32_t size;
+	std::memcpy(&size,chars.data() + offset,sizeof(size));
+	return std::string_view(chars.data() + offset + sizeof(size),size);
+}
+
+Document::Type Document::Value::type() const
+{
+	if( ! doc ) return Type::none;
+	switch(doc->tag(at)) {
+		case 'n': return Type::null;
+		case 't': case 'f': return Type::boolean;
+		case 'l': return Type::int64;
+		case 'u': return Type::uint64;
+		case 'd': return Type::real;
+		case '"': return Type::string;
+		case '{': return Type::object;
+		case '[': return Type::array;
+	}
+	return Type::none;
+}
+
+std::int64_t Document::Value::asInt64() const
+{
+	switch(type()) {
+		case Type::int64: case Type::uint64: return std::int64_t(doc->tape()[at + 1]);
+		case Type::real: return std::int64_t(asDouble());
+		default: return 0;
+	}
+}
+
+std::uint64_t Document::Value::asUInt64() const
+{
+	switch(type()) {
+		case Type::int64: case Type::uint64: return doc->tape()[at + 1];
+		case Type::real: return std::uint64_t(asDouble());
+		default: return 0;
+	}
+}
+
+double Document::Value::asDouble() const
+{
+	switch(type()) {
+		case Type::int64: return double(std::int64_t(doc->tape()[at + 1]));
+		case Type::uint64: return double(doc->tape()[at + 1]);
+		case Type::real: {
+			double value;
+			std::memcpy(&value,&doc->tape()[at + 1],sizeof(value));
+			return value;
+		}
+		default: return 0;
+	}
+}
+
+std::string_view Document::Value::asString() const
+{
+	return type() == Type::string ? doc->string(at) : std::string_view();
+}
+
+std::size_t Document::Value::size() const
+{
+	auto kind = type();
+	if( kind != Type::object && kind != Type::array ) return 0;
+
+	auto count = std::size_t(doc->tape()[at] >> 32 & 0xFFFFFF);
+	if( count < 0xFFFFFF ) return count;
+
+	// the count saturated, so the elements are counted one by one
+	count = 0;
+	for( auto it = begin(); it != end(); ++it ) {
+		++count;
+	}
+	return count;
+}
+
+Document::Value Document::Value::operator[](std::string_view key) const
+{
+	if( type() != Type::object ) return Value();
+	for( auto it = begin(); it != end(); ++it ) {
+		if( it.key() == key ) return *it;
+	}
+	return Value();
+}
+
+Document::Value Document::Value::operator[](std::size_t index) const
+{
+	if( type() != Type::array ) return Value();
+	for( auto it = begin(); it != end(); ++it ) {
+		if( index-- == 0 ) return *it;
+	}
+	return Value();
+}
+
+Document::Iterator Document::Value::begin() const
+{
+	auto kind = type();
+	if( kind != Type::object && kind != Type::array ) return Iterator(doc,0,false);
+	return Iterator(doc,at + 1,kind == Type::object);
+}
+
+Document::Iterator Document::Value::end() const
+{
+	auto kind = type();
+	if( kind != Type::object && kind != Type::array ) return Iterator(doc,0,false);
+	return Iterator(doc,doc->payload(at),kind == Type::object);
+}
+
+} /* namespace json */
+} /* namespace die */
@@ -0,0 +1,185 @@
+#ifndef JSONDOCUMENT_H_DIE_JSON_2026_10_17
+#define JSONDOCUMENT_H_DIE_JSON_2026_10_17
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "JsonBasicParser.h"
+
+namespace die {
+namespace json {
+
+// a parsed document kept on a flat tape of 64 bit words, built straight from the parser events
+// strings and keys share one buffer, numbers are converted while parsing and aggregates know where they end
+// the tape and the buffer are the whole document: clear() or the destructor free it at once
+// parsing again reuses their memory, so a document kept around stops allocating once it has grown
+class Document {
+public:
+	enum class Type { none, null, boolean, int64, uint64, real, string, object, array, };
+	class Value;
+	class Iterator;
+private:
+	// a word has its tag in the top byte and a payload below it
+	//   { [  the index of the matching end word, with the element count from bit 32 on (saturated)
+	//   } ]  the index of the matching start word
+	//   "    the offset of a string or key in chars, which holds its 32 bit size and then its chars
+	//   l u d  int64, uint64 and double. their bits take the next word
+	//   n t f  null, true and false
+	// inside objects each value is preceded by its key
+	struct Builder: BaseHandler {
+		std::vector<std::uint64_t> tape;
+		std::string chars;
+		std::vector<std::pair<std::size_t,std::size_t>> open; // start word and count of the open aggregates
+
+		static std::uint64_t word(char tag, std::uint64_t payload) { return std::uint64_t(std::uint8_t(tag)) << 56 | payload; }
+
+		void addString(std::string_view str)
+		{
+			tape.push_back(word('"',chars.size()));
+			auto size = std::uint32_t(str.size());
+			chars.append(reinterpret_cast<char const *>(&size),sizeof(size));
+			chars.append(str);
+		}
+
+		void member(std::string_view name)
+		{
+			if( open.empty() ) return;
+			++open.back().second;
+			if( tape[open.back().first] >> 56 == '{' ) {
+				addString(name);
+			}
+		}
+
+		void start(char tag, std::string_view name)
+		{
+			member(name);
+			open.emplace_back(tape.size(),0);
+			tape.push_back(word(tag,0));
+		}
+
+		void end(char tag)
+		{
+			auto [start, count] = open.back();
+			open.pop_back();
+			tape[start] |= std::min<std::uint64_t>(count,0xFFFFFF) << 32 | tape.size();
+			tape.push_back(word(tag,start));
+		}
+
+		void number(char tag, std::uint64_t bits)
+		{
+			tape.push_back(word(tag,0));
+			tape.push_back(bits);
+		}
+
+		void onStartObject(std::string_view name) { start('{',name); }
+		void onEndObject(std::string_view) { end('}'); }
+		void onStartArray(std::string_view name) { start('[',name); }
+		void onEndArray(std::string_view) { end(']'); }
+		void onString(std::string_view name, std::string_view value) { member(name); addString(value); }
+		void onBool(std::string_view name, bool value) { member(name); tape.push_back(word(value ? 't' : 'f',0)); }
+		void onNull(std::string_view name) { member(name); tape.push_back(word('n',0)); }
+		void onInt64(std::string_view name, std::int64_t value, std::string_view) { member(name); number('l',std::uint64_t(value)); }
+		void onUInt64(std::string_view name, std::uint64_t value, std::string_view) { member(name); number('u',value); }
+		void onDouble(std::string_view name, double value, std::string_view)
+		{
+			member(name);
+			std::uint64_t bits;
+			std::memcpy(&bits,&value,sizeof(bits));
+			number('d',bits);
+		}
+	};
+
+	BasicParser<Builder> parser;
+	bool complete = false;
+
+	std::vector<std::uint64_t> const & tape() const { return parser.getHandler().tape; }
+	char tag(std::size_t at) const { return char(tape()[at] >> 56); }
+	std::size_t payload(std::size_t at) const { return std::size_t(tape()[at] & 0xFFFFFFFFull); }
+	std::size_t next(std::size_t at) const;
+	std::string_view string(std::size_t at) const;
+	bool finish(bool parsed);
+public:
+	Document() = default;
+	Document(Document const &) = delete;
+	Document & operator=(Document const &) = delete;
+
+	// the previous contents are gone once a parse starts. after a failed parse, thrown or not, the document is empty
+	bool parse(std::string_view text);
+	bool parse(std::istream & is);
+	bool parseFile(std::string const & path);
+
+	Document & engine(Engine engineType) { parser.engine(engineType); return *this; }
+	Document & throwErrors(bool throwing) { parser.throwErrors(throwing); return *this; }
+	Error const & error() const { return parser.error(); }
+
+	bool empty() const { return ! complete; }
+	void clear();
+	// the root object or array. a none value when the document is empty
+	Value root() const;
+};
+
+// a light handle to a value of a Document. valid while the document is not parsed again or cleared
+// lookups that find nothing give a none value, which is false, and the accessors of a wrong type give zero or empty
+class Document::Value {
+	friend class Document;
+	friend class Document::Iterator;
+	Document const * doc;
+	std::size_t at;
+
+	Value(Document const * doc, std::size_t at): doc(doc), at(at) {}
+public:
+	Value(): doc(nullptr), at(0) {}
+
+	Type type() const;
+	explicit operator bool() const { return doc != nullptr; }
+
+	bool asBool() const { return doc && doc->tag(at) == 't'; }
+	// numbers convert between the three types as static_cast would
+	std::int64_t asInt64() const;
+	std::uint64_t asUInt64() const;
+	double asDouble() const;
+	std::string_view asString() const;
+
+	// elements of an array or members of an object
+	std::size_t size() const;
+	// the member with key. a linear walk over the members that jumps over nested aggregates
+	Value operator[](std::string_view key) const;
+	// the element at index. the walk jumps over nested aggregates too
+	Value operator[](std::size_t index) const;
+
+	Iterator begin() const;
+	Iterator end() const;
+};
+
+// walks the elements of an array or the members of an object, in document order
+class Document::Iterator {
+	friend class Document::Value;
+	Document const * doc;
+	std::size_t at;	// the key of a member or the element
+	bool members;
+
+	Iterator(Document const * doc, std::size_t at, bool members): doc(doc), at(at), members(members) {}
+public:
+	Value operator*() const { return Value(doc,members ? at + 1 : at); }
+	// the key of the current member. empty inside arrays
+	std::string_view key() const { return members ? doc->string(at) : std::string_view(); }
+
+	Iterator & operator++()
+	{
+		at = doc->next(members ? at + 1 : at);
+		return *this;
+	}
+
+	bool operator==(Iterator const & other) const { return at == other.at; }
+	bool operator!=(Iterator const & other) const { return at != other.at; }
+};
+
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONDOCUMENT_H_ */
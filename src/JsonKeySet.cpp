@@ -0,0 +1,47 @@
+#include "JsonKeySet.h"
+
+namespace die {
+namespace json {
+
+KeySet::KeySet(std::initializer_list<std::string_view> keys)
+{
+	for( auto key : keys ) {
+		add(key);
+	}
+}
+
+KeySet::KeyId KeySet::add(std::string_view key)
+{
+	auto id = find(key);
+	if( id != unknown ) return id;
+
+	id = KeyId(entries.size());
+	entries.push_back({chars.size(),key.size(),hash(key)});
+	chars.append(key);
+	if( entries.size() * 2 > slots.size() ) {
+		rehash(slots.empty() ? 16 : slots.size() * 2);
+	} else {
+		auto slot = entries.back().hash & mask;
+		while( slots[slot] != unknown ) {
+			slot = (slot + 1) & mask;
+		}
+		slots[slot] = id;
+	}
+	return id;
+}
+
+void KeySet::rehash(std::size_t slotCount)
+{
+	slots.assign(slotCount,unknown);
+	mask = slotCount - 1;
+	for( KeyId id = 0; id != KeyId(entries.size()); ++id ) {
+		auto slot = entries[id].hash & mask;
+		while( slots[slot] != unknown ) {
+			slot = (slot + 1) & mask;
+		}
+		slots[slot] = id;
+	}
+}
+
+} /* namespace json */
+} /* namespace die */
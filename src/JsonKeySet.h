@@ -0,0 +1,67 @@
+#ifndef JSONKEYSET_H_DIE_JSON_2026_10_17
+#define JSONKEYSET_H_DIE_JSON_2026_10_17
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace die {
+namespace json {
+
+// keys registered up front get small ids, assigned in registration order
+// the parser looks every object name up once when it ends and hands the id with the events
+class KeySet {
+public:
+	using KeyId = int;
+	static constexpr KeyId unknown = -1;
+
+	KeySet() = default;
+	KeySet(std::initializer_list<std::string_view> keys);
+
+	// returns the id the key already had, if any. do not add keys while a parser is using the set
+	KeyId add(std::string_view key);
+	KeyId find(std::string_view key) const
+	{
+		if( entries.empty() ) return unknown;
+		auto h = hash(key);
+		for( auto slot = h & mask; slots[slot] != unknown; slot = (slot + 1) & mask ) {
+			auto const & entry = entries[slots[slot]];
+			if( entry.hash == h && this->key(slots[slot]) == key ) return slots[slot];
+		}
+		return unknown;
+	}
+
+	std::string_view key(KeyId id) const { return std::string_view(chars).substr(entries[id].offset,entries[id].size); }
+	std::size_t size() const { return entries.size(); }
+	bool empty() const { return entries.empty(); }
+private:
+	struct Entry {
+		std::size_t offset;
+		std::size_t size;
+		std::uint64_t hash;
+	};
+	std::string chars;
+	std::vector<Entry> entries;
+	std::vector<KeyId> slots; // open addressing, kept at most half full
+	std::size_t mask = 0;
+
+	static std::uint64_t hash(std::string_view key)
+	{
+		// FNV-1a
+		std::uint64_t h = 14695981039346656037ull;
+		for( unsigned char ch : key ) {
+			h = (h ^ ch) * 1099511628211ull;
+		}
+		return h;
+	}
+
+	void rehash(std::size_t slotCount);
+};
+
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONKEYSET_H_ */
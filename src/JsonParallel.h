@@ -0,0 +1,634 @@
+#ifndef JSONPARALLEL_H_DIE_JSON_2026_10_17
+#define JSONPARALLEL_H_DIE_JSON_2026_10_17
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "JsonBasicParser.h"
+
+namespace die {
+namespace json {
+
+// a run of elements of the root array, ready for BasicParser::parseElements(), or a run of JSON Lines
+struct Piece {
+	char const * begin;
+	char const * end;
+	std::size_t first;	// index of its first element or line
+	Position pos;	// of begin
+	bool last;
+};
+
+// cuts the root array into pieces of at least pieceSize bytes, ending right after a comma of the root array
+// the last piece runs to the end of the document. emit(Piece) returns false to stop the cutting
+// only the structural index is walked, so a broken document is cut anywhere and left for the parser to report
+// returns false when the root is not an array
+template<typename Emit>
+bool splitElements(char const * data, std::size_t size, std::size_t pieceSize, Emit && emit)
+{
+	auto end = data + size;
+	simd::Lines lines;
+	auto begin = simd::skipWhitespace(data,end,lines);
+	if( begin == end || *begin != '[' ) return false;
+	++begin;
+	Position pos{int(begin - (lines.count ? lines.lastStart : data)) + 1,int(lines.count) + 1};
+
+	auto moveTo = [&](char const * next) {
+		auto lines = simd::countLines(begin,next);
+		if( lines.count == 0 ) {
+			pos.column += int(next - begin);
+		} else {
+			pos.line += int(lines.count);
+			pos.column = int(next - lines.lastStart) + 1;
+		}
+		begin = next;
+	};
+
+	std::size_t const window = 64 * 1024;
+	std::vector<std::uint32_t> stops(window + simd::indexSlack);
+	simd::IndexCarry carry;
+	std::size_t depth = 0;	// below the root array
+	std::size_t elements = 0;
+	std::size_t first = 0;
+	for( auto p = begin; p != end; ) {
+		auto windowEnd = std::size_t(end - p) > window ? p + window : end;
+		auto last = simd::buildIndex(p,p,windowEnd,carry,stops.data());
+		for( auto stop = stops.data(); stop != last; ++stop ) {
+			auto q = p + *stop;
+			switch(*q) {
+				case '{': case '[':
+					++depth;
+					break;
+				case '}': case ']':
+					if( depth == 0 ) {
+						emit(Piece{begin,end,first,pos,true});
+						return true;
+					}
+					--depth;
+					break;
+				case ',':
+					if( depth != 0 ) break;
+					++elements;
+					if( std::size_t(q + 1 - begin) >= pieceSize ) {
+						if( ! emit(Piece{begin,q + 1,first,pos,false}) ) return true;
+						moveTo(q + 1);
+						first = elements;
+					}
+					break;
+			}
+		}
+		p = windowEnd;
+	}
+	emit(Piece{begin,end,first,pos,true});
+	return true;
+}
+
+// cuts JSON Lines into pieces of at least pieceSize bytes that end right after a newline
+template<typename Emit>
+void splitLines(char const * data, std::size_t size, std::size_t pieceSize, Emit && emit)
+{
+	auto end = data + size;
+	auto begin = data;
+	std::size_t lines = 0;
+	while( std::size_t(end - begin) > pieceSize ) {
+		auto from = begin + pieceSize - 1;
+		auto newline = static_cast<char const *>(std::memchr(from,'\n',end - from));
+		if( ! newline ) break;
+		if( ! emit(Piece{begin,newline + 1,lines,{1,int(lines) + 1},false}) ) return;
+		lines += simd::countLines(begin,newline + 1).count;
+		begin = newline + 1;
+	}
+	emit(Piece{begin,end,lines,{1,int(lines) + 1},true});
+}
+
+// keeps the events of a piece, so they can be delivered in order by another thread
+class EventTape {
+	enum class Kind : std::uint8_t { startObject, endObject, startArray, endArray, string, number, boolean, null, };
+	struct Event {
+		Kind kind;
+		bool value;	// of booleans
+		std::uint32_t nameSize;
+		std::uint32_t valueSize;	// name and value follow each other in chars
+		std::size_t stopOffset;	// in the piece, had the event stopped the parse
+	};
+	std::vector<Event> events;
+	std::string chars;
+
+	void add(Kind kind, std::string_view name, std::string_view value = std::string_view(), bool boolean = false)
+	{
+		auto stopOffset = parser ? parser->currentStopOffset() : 0;
+		events.push_back({kind,boolean,std::uint32_t(name.size()),std::uint32_t(value.size()),stopOffset});
+		chars.append(name);
+		chars.append(value);
+	}
+
+	template<typename Call>
+	static Control result(Call && call)
+	{
+		if constexpr( std::is_void_v<decltype(call())> ) {
+			call();
+			return Control::proceed;
+		} else {
+			return call();
+		}
+	}
+public:
+	BasicParser<EventTape> const * parser = nullptr;	// the one recording, for the offsets of the events
+
+	void onStartObject(std::string_view name) { add(Kind::startObject,name); }
+	void onEndObject(std::string_view name) { add(Kind::endObject,name); }
+	void onStartArray(std::string_view name) { add(Kind::startArray,name); }
+	void onEndArray(std::string_view name) { add(Kind::endArray,name); }
+	void onString(std::string_view name, std::string_view value) { add(Kind::string,name,value); }
+	void onNumber(std::string_view name, std::string_view value) { add(Kind::number,name,value); }
+	void onBool(std::string_view name, bool value) { add(Kind::boolean,name,std::string_view(),value); }
+	void onNull(std::string_view name) { add(Kind::null,name); }
+
+	bool empty() const { return events.empty(); }
+
+	void clear()
+	{
+		events.clear();
+		chars.clear();
+	}
+
+	// where a replay is. it goes on from one tape to the next
+	struct Cursor {
+		std::ptrdiff_t depth = 0;	// open aggregates below the root array
+		std::ptrdiff_t skipTo = -1;	// while skipping, the depth whose end event ends the skip
+		bool skipping = false;
+		bool stopped = false;
+		std::size_t stoppedAt = 0;	// byte offset in the document right after the char that completed the stopping event
+		bool rootSkipped = false;	// an event skipped the rest of the root array, so no tape is left to replay
+		bool rootArray = true;	// the tapes are pieces of a root array, not JSON Lines or a whole document
+
+		bool over() const { return stopped || rootSkipped; }
+	};
+
+	// calls the handler events as the parser would have, Control included. numbers go to the typed events if it has them
+	// start is the offset of the piece in the document
+	template<typename Handler>
+	void replay(Handler & handler, Cursor & cursor, std::size_t start) const
+	{
+		std::size_t offset = 0;
+		for( auto const & event : events ) {
+			if( cursor.over() ) return;
+			std::string_view name(chars.data() + offset,event.nameSize);
+			std::string_view value(chars.data() + offset + event.nameSize,event.valueSize);
+			offset += event.nameSize + event.valueSize;
+
+			bool closes = event.kind == Kind::endObject || event.kind == Kind::endArray;
+			if( event.kind == Kind::startObject || event.kind == Kind::startArray ) {
+				++cursor.depth;
+			} else if( closes ) {
+				--cursor.depth;
+			}
+			if( cursor.skipping ) {
+				if( closes && cursor.depth == cursor.skipTo ) {
+					cursor.skipping = false;	// the skipped end event is not called either
+				}
+				continue;
+			}
+
+			Control control = Control::proceed;
+			switch(event.kind) {
+				case Kind::startObject: control = result([&] { return handler.onStartObject(name); }); break;
+				case Kind::endObject: control = result([&] { return handler.onEndObject(name); }); break;
+				case Kind::startArray: control = result([&] { return handler.onStartArray(name); }); break;
+				case Kind::endArray: control = result([&] { return handler.onEndArray(name); }); break;
+				case Kind::string: control = result([&] { return handler.onString(name,value); }); break;
+				case Kind::boolean: control = result([&] { return handler.onBool(name,event.value); }); break;
+				case Kind::null: control = result([&] { return handler.onNull(name); }); break;
+				case Kind::number:
+					if constexpr( has_typed_numbers<Handler>::value ) {
+						typedNumberEvent(handler,name,value,value.find_first_of(".eE") == value.npos,
+							[&](auto && call) { control = result(call); });
+					} else {
+						control = result([&] { return handler.onNumber(name,value); });
+					}
+					break;
+			}
+			if( control == Control::stop ) {
+				cursor.stopped = true;
+				cursor.stoppedAt = start + event.stopOffset;
+			} else if( control == Control::skip ) {
+				if( cursor.depth != 0 ) {
+					// a start event skips its own aggregate, the others what is left of the innermost open one
+					cursor.skipping = true;
+					cursor.skipTo = cursor.depth - 1;
+				} else if( cursor.rootArray ) {
+					// the rest of the root array. as with parseElements(), the later pieces are left out
+					cursor.rootSkipped = true;
+				}
+				// otherwise the record or the document is over and, as with BasicParser, nothing is left to skip
+			}
+		}
+	}
+};
+
+// parses a large root array on several threads. a splitter thread cuts it into pieces with splitElements()
+// and the workers parse whole pieces, each with a BasicParser of its own
+// parse() delivers the events to one handler per worker, so elements come in no particular order between workers
+// parseOrdered() records them in the workers and delivers them in document order to a single handler instead
+// the root array has no events of its own. documents with any other root are parsed on the calling thread
+// parseLines() and parseLinesOrdered() do the same for JSON Lines, cut with splitLines()
+// an event that skips the rest of the root array ends the parse, which still succeeds. the elements after it
+// are not checked, and with parse() other workers may have delivered some of them already
+template<typename Handler>
+class ParallelParser {
+public:
+	using CharType = char;
+	using HandlerFactory = std::function<Handler(unsigned worker)>;
+private:
+	struct Outcome {
+		Error err;
+		bool stopped = false;
+		bool rootSkipped = false;
+		std::size_t stoppedAt = 0;
+		std::exception_ptr exception;
+	};
+
+	// what the threads of one parse share. everything is guarded by mutex
+	struct Run {
+		CharType const * data;
+		std::mutex mutex;
+		std::condition_variable changed;
+		std::vector<Piece> pieces;
+		bool split = false;
+		std::size_t next = 0;
+		std::size_t failed = npos;	// first piece that failed or stopped
+		Outcome outcome;	// of that piece
+		bool cancelled = false;	// by the ordered handler or by an exception on the calling thread
+		bool lines = false;
+		bool wholeDocument = false;	// any other root than an array, parsed as one piece
+		std::vector<Error> badLines;
+		// ordered delivery
+		std::vector<EventTape> tapes;
+		std::vector<char> ready;
+		std::size_t delivered = 0;
+		std::size_t ahead = npos;	// how many pieces past the delivered ones may be parsed
+		std::size_t ended = npos;	// the piece where the ordered handler stopped or skipped the rest of the root
+
+		bool finished() const { return cancelled || next >= failed || (split && next >= pieces.size()); }
+		bool available() const { return next < pieces.size() && next - delivered < ahead; }
+
+		void cancel()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			cancelled = true;
+			changed.notify_all();
+		}
+	};
+
+	static std::size_t const npos = std::size_t(-1);
+
+	HandlerFactory makeHandler;
+	std::vector<std::unique_ptr<BasicParser<Handler>>> parsers;
+	unsigned threadCount;
+	std::size_t pieceBytes;
+	Engine engineType;
+	KeySet keySet;
+	PathFilter filter;
+	bool throwing;
+	bool isolating;
+	std::vector<Error> failedLines;
+	Error err;
+	bool wasStopped;
+	std::size_t stoppedAt;
+public:
+	explicit ParallelParser(HandlerFactory makeHandler = [](unsigned) { return Handler(); }):
+		makeHandler(std::move(makeHandler)),
+		threadCount(0),
+		pieceBytes(1 << 20),
+		engineType(Engine::automaton),
+#ifdef DIE_JSON_EXCEPTIONS
+		throwing(true),
+#else
+		throwing(false),
+#endif
+		isolating(false),
+		wasStopped(false),
+		stoppedAt(0)
+	{
+	}
+
+	// zero means one per hardware thread
+	ParallelParser & threads(unsigned count) { threadCount = count; return *this; }
+	// smaller pieces spread the work better, larger ones cost less to hand out
+	ParallelParser & pieceSize(std::size_t bytes) { pieceBytes = std::max<std::size_t>(bytes,1); return *this; }
+	ParallelParser & engine(Engine engineType) { this->engineType = engineType; return *this; }
+	ParallelParser & keys(KeySet keySet) { this->keySet = std::move(keySet); return *this; }
+	ParallelParser & subscribe(PathFilter filter) { this->filter = std::move(filter); return *this; }
+	ParallelParser & throwErrors([[maybe_unused]] bool throwing)
+	{
+#ifdef DIE_JSON_EXCEPTIONS
+		this->throwing = throwing;
+#endif
+		return *this;
+	}
+
+	// with isolateLines(true) the JSON Lines that fail are kept in badLines(), sorted, and the others are parsed anyway
+	ParallelParser & isolateLines(bool isolating) { this->isolating = isolating; return *this; }
+	std::vector<Error> const & badLines() const { return failedLines; }
+
+	// the handlers are made on first use and kept between parses
+	unsigned workers() const { return unsigned(parsers.size()); }
+	Handler & getHandler(unsigned worker) { return parsers[worker]->getHandler(); }
+
+	// the error of the first piece that failed, with its position in the document
+	Error const & error() const { return err; }
+	bool stopped() const { return wasStopped; }
+	// byte offset in the document right after the char that completed the stopping event
+	std::size_t stopOffset() const { return stoppedAt; }
+
+	bool parse(CharType const * data, std::size_t size) { return unordered(data,size,false); }
+	bool parseLines(CharType const * data, std::size_t size) { return unordered(data,size,true); }
+
+	bool parse(std::basic_string_view<CharType> text) { return parse(text.data(),text.size()); }
+	bool parseLines(std::basic_string_view<CharType> text) { return parseLines(text.data(),text.size()); }
+
+	// maps the file and parses it in place
+	bool parseFile(std::string const & path)
+	{
+		MappedFile file(path);
+		if( file.error() ) {
+			err = Error{ErrorCode::unreadableFile,{1,1},0,0,{}};
+			return false;
+		}
+		return parse(file.data(),file.size());
+	}
+
+	// the events arrive at handler on the calling thread in document order, Control included
+	// a Control::stop ends the parse, though the workers may have parsed a few pieces further
+	template<typename OrderedHandler>
+	bool parseOrdered(CharType const * data, std::size_t size, OrderedHandler & handler)
+	{
+		return ordered(data,size,handler,false);
+	}
+
+	template<typename OrderedHandler>
+	bool parseOrdered(std::basic_string_view<CharType> text, OrderedHandler & handler)
+	{
+		return ordered(text.data(),text.size(),handler,false);
+	}
+
+	template<typename OrderedHandler>
+	bool parseLinesOrdered(CharType const * data, std::size_t size, OrderedHandler & handler)
+	{
+		return ordered(data,size,handler,true);
+	}
+
+	template<typename OrderedHandler>
+	bool parseLinesOrdered(std::basic_string_view<CharType> text, OrderedHandler & handler)
+	{
+		return ordered(text.data(),text.size(),handler,true);
+	}
+private:
+	bool unordered(CharType const * data, std::size_t size, bool lines)
+	{
+		auto count = prepare(parsers,[this](unsigned worker) { return makeHandler(worker); });
+		return run(data,size,lines,count,parsers,[](Run &, std::size_t, BasicParser<Handler> &) {},nullptr);
+	}
+
+	template<typename OrderedHandler>
+	bool ordered(CharType const * data, std::size_t size, OrderedHandler & handler, bool lines)
+	{
+		std::vector<std::unique_ptr<BasicParser<EventTape>>> recorders;
+		auto count = prepare(recorders,[](unsigned) { return EventTape(); });
+		for( auto & recorder : recorders ) {
+			recorder->getHandler().parser = recorder.get();
+		}
+		EventTape::Cursor cursor;
+		// called with the lock held, as the workers finish their pieces
+		auto record = [](Run & run, std::size_t index, BasicParser<EventTape> & parser) {
+			if( run.tapes.size() <= index ) {
+				run.tapes.resize(index + 1);
+				run.ready.resize(index + 1);
+			}
+			run.tapes[index] = std::move(parser.getHandler());
+			run.ready[index] = true;
+			parser.getHandler().clear();
+		};
+		std::function<void(Run &)> deliver = [&](Run & run) {
+			std::unique_lock<std::mutex> lock(run.mutex);
+			for(;;) {
+				run.changed.wait(lock,[&] {
+					return (run.delivered < run.ready.size() && run.ready[run.delivered])
+						|| (run.split && run.delivered >= run.pieces.size());
+				});
+				if( run.delivered >= run.ready.size() || ! run.ready[run.delivered] ) return;
+				auto tape = std::move(run.tapes[run.delivered]);
+				auto start = std::size_t(run.pieces[run.delivered].begin - run.data);
+				// a failed piece delivers the events before the failure and ends the parse
+				bool last = run.delivered == run.failed;
+				cursor.rootArray = ! run.lines && ! run.wholeDocument;
+				lock.unlock();
+				tape.replay(handler,cursor,start);
+				lock.lock();
+				if( cursor.over() ) {
+					run.ended = run.delivered;
+					run.cancelled = true;
+				}
+				++run.delivered;
+				run.changed.notify_all();
+				if( last || cursor.over() ) return;
+			}
+		};
+		auto parsed = run(data,size,lines,count,recorders,record,&deliver);
+		if( cursor.stopped ) {
+			wasStopped = true;
+			stoppedAt = cursor.stoppedAt;
+			return false;
+		}
+		return parsed || cursor.rootSkipped;
+	}
+
+	template<typename Parsers, typename Make>
+	unsigned prepare(Parsers & workers, Make && make)
+	{
+		using Worker = typename Parsers::value_type::element_type;
+		auto count = threadCount ? threadCount : std::max(1u,std::thread::hardware_concurrency());
+		while( workers.size() < count ) {
+			workers.push_back(std::make_unique<Worker>(make(unsigned(workers.size()))));
+		}
+		for( auto & parser : workers ) {
+			parser->engine(engineType).keys(keySet);
+			parser->subscribe(filter);
+			parser->throwErrors(false);
+			parser->isolateLines(isolating);
+		}
+		err = Error();
+		failedLines.clear();
+		wasStopped = false;
+		stoppedAt = 0;
+		return count;
+	}
+
+	template<typename Parsers, typename Done>
+	bool run(CharType const * data, std::size_t size, bool lines, unsigned count, Parsers & workers, Done && done,
+		std::function<void(Run &)> const * deliver)
+	{
+		Run run;
+		run.data = data;
+		run.lines = lines;
+		if( deliver ) {
+			run.ahead = std::size_t(count) * 4;
+		}
+		std::vector<std::thread> threads;
+		for( unsigned worker = 0; worker < count; ++worker ) {
+			threads.emplace_back([&,worker] { work(run,*workers[worker],done); });
+		}
+		bool isArray = true;
+		std::thread splitter([&] {
+			auto emit = [&run](Piece const & piece) {
+				std::lock_guard<std::mutex> lock(run.mutex);
+				if( run.cancelled || run.failed != npos ) return false;
+				run.pieces.push_back(piece);
+				run.changed.notify_all();
+				return true;
+			};
+			if( lines ) {
+				splitLines(data,size,pieceBytes,emit);
+			} else {
+				isArray = splitElements(data,size,pieceBytes,emit);
+			}
+			std::lock_guard<std::mutex> lock(run.mutex);
+			run.split = true;
+			run.changed.notify_all();
+		});
+		std::exception_ptr delivering;
+		if( deliver ) {
+#ifdef DIE_JSON_EXCEPTIONS
+			try {
+#endif
+				(*deliver)(run);
+#ifdef DIE_JSON_EXCEPTIONS
+			} catch(...) {
+				delivering = std::current_exception();
+				run.cancel();
+			}
+#endif
+		}
+		splitter.join();
+		for( auto & thread : threads ) {
+			thread.join();
+		}
+#ifdef DIE_JSON_EXCEPTIONS
+		if( delivering ) {
+			std::rethrow_exception(delivering);
+		}
+#endif
+
+		if( ! isArray ) {
+			// any other root is parsed here as a whole. the ordered handler may stop before an error, so that one
+			// is only thrown after the events
+			auto & parser = *workers[0];
+			parser.throwErrors(throwing && ! deliver);
+			auto parsed = parser.parse(data,size);
+			parser.throwErrors(false);
+			err = parser.error();
+			wasStopped = parser.stopped();
+			stoppedAt = parser.stopOffset();
+			if( deliver ) {
+				done(run,0,parser);
+				run.pieces.assign(1,Piece{data,data + size,0,{1,1},true});
+				run.wholeDocument = true;
+				(*deliver)(run);
+				if( run.ended == 0 ) {
+					err = Error();
+					return false;
+				}
+				raiseError();
+			}
+			return parsed;
+		}
+		failedLines = std::move(run.badLines);
+		std::sort(failedLines.begin(),failedLines.end(),[](Error const & a, Error const & b) { return a.pos.line < b.pos.line; });
+		if( run.failed != npos && run.failed >= run.ended ) {
+			run.failed = npos;	// the ordered handler was over before that piece went wrong
+		}
+		if( run.failed == npos ) return ! run.cancelled;
+
+		auto const & outcome = run.outcome;
+#ifdef DIE_JSON_EXCEPTIONS
+		if( outcome.exception ) {
+			std::rethrow_exception(outcome.exception);
+		}
+#endif
+		if( outcome.rootSkipped ) return true;
+		if( outcome.stopped ) {
+			wasStopped = true;
+			stoppedAt = outcome.stoppedAt;
+			return false;
+		}
+		err = outcome.err;
+		raiseError();
+		return false;
+	}
+
+	void raiseError() const
+	{
+#ifdef DIE_JSON_EXCEPTIONS
+		// as with BasicParser, rejected chars and incomplete documents are not thrown
+		if( err && throwing && err.code != ErrorCode::rejectedChar && err.code != ErrorCode::incomplete ) {
+			raise(err);
+		}
+#endif
+	}
+
+	template<typename Parser, typename Done>
+	void work(Run & run, Parser & parser, Done & done)
+	{
+		std::unique_lock<std::mutex> lock(run.mutex);
+		for(;;) {
+			run.changed.wait(lock,[&] { return run.finished() || run.available(); });
+			if( run.finished() ) return;
+			auto index = run.next++;
+			auto piece = run.pieces[index];
+			lock.unlock();
+
+			Outcome outcome;
+			bool parsed = false;
+#ifdef DIE_JSON_EXCEPTIONS
+			try {
+#endif
+				auto size = std::size_t(piece.end - piece.begin);
+				parsed = run.lines
+					? parser.parseLines(piece.begin,size,piece.pos.line)
+					: parser.parseElements(piece.begin,size,piece.first,piece.pos,piece.last);
+#ifdef DIE_JSON_EXCEPTIONS
+			} catch(...) {
+				outcome.exception = std::current_exception();
+			}
+#endif
+			lock.lock();
+			if( run.lines ) {
+				auto & bad = parser.badLines();
+				run.badLines.insert(run.badLines.end(),bad.begin(),bad.end());
+			}
+			if( ! parsed && index < run.failed ) {
+				outcome.err = parser.error();
+				outcome.stopped = parser.stopped();
+				outcome.rootSkipped = parser.skippedRoot();
+				outcome.stoppedAt = std::size_t(piece.begin - run.data) + parser.stopOffset();
+				run.failed = index;
+				run.outcome = std::move(outcome);
+			}
+			done(run,index,parser);
+			run.changed.notify_all();
+		}
+	}
+};
+
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONPARALLEL_H_ */
@@ -3,82 +3,70 @@
 
 #include <functional>
 #include <string>
-#include <stack>
-#include <istream>
-#include "automata/automata.h"
-#include "JsonParserObjects.h"
+#include <string_view>
+#include "JsonBasicParser.h"
 
 namespace die {
 namespace json {
 
-template<typename CharType>
-struct CharTraits {
-	template<typename U>
-	static std::basic_string<CharType> parseUnicode(std::basic_string<U> const & strCode) {
-		// default is just to passthrough the encoded char for the client to encode
-		return "\\u" + strCode;
-	}
+// handler that forwards the events to std::function callbacks
+struct FunctionHandler {
+	using NameView = std::string_view;
+	using ValueView = std::string_view;
+	using start_view_event = std::function<void(NameView)>;
+	using end_view_event = std::function<void(NameView)>;
+	using value_view_event = std::function<void(NameView, ValueType, ValueView)>;
+
+	start_view_event startObjectFn;
+	end_view_event endObjectFn;
+	start_view_event startArrayFn;
+	end_view_event endArrayFn;
+	value_view_event valueFn;
+
+	FunctionHandler();
+
+	void onStartObject(NameView name) { startObjectFn(name); }
+	void onEndObject(NameView name) { endObjectFn(name); }
+	void onStartArray(NameView name) { startArrayFn(name); }
+	void onEndArray(NameView name) { endArrayFn(name); }
+	void onString(NameView name, ValueView value) { valueFn(name,ValueType::string,value); }
+	void onNumber(NameView name, ValueView value) { valueFn(name,ValueType::number,value); }
+	// the parser passes keywords as views into the input. the other two are left for replays, like ParallelParser's
+	void onKeyword(NameView name, ValueType type, ValueView text) { valueFn(name,type,text); }
+	void onBool(NameView name, bool value) { valueFn(name,ValueType::boolean,value ? "true" : "false"); }
+	void onNull(NameView name) { valueFn(name,ValueType::null,"null"); }
 };
 
-class Parser {
+class Parser: public BasicParser<FunctionHandler> {
 public:
-	using CharType = char; // TODO template it. type needs to be convertible from char
 	using ObjectName = std::basic_string<CharType>;
 	using ValueStr = std::basic_string<CharType>;
 
 	using start_event = std::function<void(ObjectName const &)>;
 	using end_event = std::function<void(ObjectName const &)>;
 	using value_event = std::function<void(ObjectName const &, ValueType, ValueStr const &)>;
-private:
-	using Automata = automata::FiniteAutomata<automata::Range<CharType>,automata::MealyTransition<automata::Range<CharType>>>;
-	enum class Status { start, object, array, };
-	enum class NumberPart { beforeDot, afterDot, afterE, };
-	struct Context {
-		Status status;
-		ValueStr objectName;
-	};
-	using Contexts = std::stack<Context>;
-
-	Contexts contexts;
-	Context context;
-
-	bool isObjectName;
-	ObjectName objectName;
-	ValueStr valueStr;
-	ValueStr unicodeStr;
-	ValueType keywordType;
-	NumberPart numberPart;
 
-	Automata parserAut;
+	// zero-copy events. when parsing a contiguous buffer, names and values without escapes point straight into it
+	// otherwise they point to a scratch buffer. either way they are only valid during the call
+	using start_view_event = FunctionHandler::start_view_event;
+	using end_view_event = FunctionHandler::end_view_event;
+	using value_view_event = FunctionHandler::value_view_event;
 
-	Position pos;
-
-	start_event startObjectFn;
-	end_event endObjectFn;
-	start_event startArrayFn;
-	end_event endArrayFn;
-	value_event valueFn;
-public:
-	Parser();
 	Parser & startObject(start_event fn);
 	Parser & endObject(end_event fn);
 	Parser & startArray(start_event fn);
 	Parser & endArray(end_event fn);
 	Parser & value(value_event fn);
-
-	bool parse(std::basic_istream<CharType> & is);
-
-	Position lastPosition() const { return pos; }
-private:
-	// aux dumb functions to avoid strange captures on local lambdas
-	using CharFunc = std::function<void(char)>;
-	void changeContext(Status status);
-	void popContext(char ch);
-	void emitValue(ValueType valueType);
-	void emitAndClear(ValueType valueType);
-	void emitAndEnd(ValueType valueType, CharFunc endFn, char ch);
-	void startValue();
-	void addValue(char ch);
+	// the view setters replace the corresponding string callbacks and vice-versa
+	Parser & startObjectView(start_view_event fn);
+	Parser & endObjectView(end_view_event fn);
+	Parser & startArrayView(start_view_event fn);
+	Parser & endArrayView(end_view_event fn);
+	Parser & valueView(value_view_event fn);
+	Parser & engine(Engine engineType);
+	Parser & keys(KeySet keySet);
+	using BasicParser::keys;
+	Parser & subscribe(PathFilter filter);
 };
 
 } /* namespace json */
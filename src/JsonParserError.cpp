@@ -0,0 +1,66 @@
+#include "JsonParserError.h"
+#include <sstream>
+
+namespace {
+
+// runs of three or more chars are shown as ranges. whitespace is left out, since it goes anywhere between tokens
+void listChars(std::ostream & os, std::bitset<256> const & chars)
+{
+	for( unsigned ch = 0; ch < chars.size(); ++ch ) {
+		if( ! chars[ch] || ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' ) continue;
+		auto last = ch;
+		while( last + 1 < chars.size() && chars[last + 1] ) {
+			++last;
+		}
+		os << ' ' << char(ch);
+		if( last - ch >= 2 ) {
+			os << '-' << char(last);
+			ch = last;
+		}
+	}
+}
+
+}
+
+namespace die {
+namespace json {
+
+std::string Error::message() const
+{
+	std::ostringstream oss;
+	oss << pos;
+	switch(code) {
+		case ErrorCode::none:
+			return "no error";
+		case ErrorCode::unexpectedChar:
+		case ErrorCode::unexpectedObjectClosing:
+		case ErrorCode::unexpectedArrayClosing:
+			oss << " unexpected char " << offendingChar;
+			break;
+		case ErrorCode::expectedChar:
+			oss << " expected char " << expectedChar << " but it was " << offendingChar;
+			break;
+		case ErrorCode::emptyObjectName:
+			oss << " empty object name";
+			break;
+		case ErrorCode::loneSurrogate:
+			oss << " lone utf-16 surrogate at char " << offendingChar;
+			break;
+		case ErrorCode::rejectedChar:
+			oss << " rejected char " << offendingChar;
+			if( acceptedChars.any() ) {
+				oss << " but expected one of";
+				listChars(oss,acceptedChars);
+			}
+			break;
+		case ErrorCode::incomplete:
+			oss << " incomplete document";
+			break;
+		case ErrorCode::unreadableFile:
+			return "cannot read file";
+	}
+	return oss.str();
+}
+
+} /* namespace json */
+} /* namespace die */
@@ -0,0 +1,38 @@
+#ifndef JSONPARSERERROR_H_DIE_JSON_2026_10_17
+#define JSONPARSERERROR_H_DIE_JSON_2026_10_17
+
+#include <bitset>
+#include <string>
+#include "JsonParserObjects.h"
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define DIE_JSON_EXCEPTIONS
+#endif
+
+namespace die {
+namespace json {
+
+enum class ErrorCode {
+	none,
+	unexpectedChar, expectedChar, emptyObjectName, loneSurrogate, unexpectedObjectClosing, unexpectedArrayClosing,
+	rejectedChar,	// the grammar has no transition for the char
+	incomplete,		// the input ended before the document did
+	unreadableFile,	// parseFile could not map the file. only without exceptions
+};
+
+// a syntax error as plain data. the message is only formatted when asked for
+struct Error {
+	ErrorCode code = ErrorCode::none;
+	Position pos = {0,0};
+	char offendingChar = 0;
+	char expectedChar = 0;	// only for expectedChar
+	std::bitset<256> acceptedChars;	// only for rejectedChar: the chars the grammar takes where it was found
+
+	explicit operator bool() const { return code != ErrorCode::none; }
+	std::string message() const;
+};
+
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONPARSERERROR_H_ */
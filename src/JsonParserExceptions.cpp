@@ -1,37 +1,45 @@
 #include "JsonParserExceptions.h"
-#include <sstream>
 
 namespace die {
 namespace json {
 
-using namespace std::string_literals;
-
-std::string posToStr(die::json::Position const & pos)
-{
-	std::ostringstream oss;
-	oss << pos;
-	return oss.str();
-}
-
 UnexpectedChar::UnexpectedChar(std::string const & message, char ch):
 	Exception(message),
 	ch(ch)
 {}
 
 UnexpectedChar::UnexpectedChar(Position pos, char ch):
-	Exception(posToStr(pos) + " unexpected char "s + ch),
+	Exception(Error{ErrorCode::unexpectedChar,pos,ch,0,{}}.message()),
 	ch(ch)
 {}
 
 ExpectedChar::ExpectedChar(Position pos, char expected, char ch):
-	UnexpectedChar(posToStr(pos) + " expected char "s + expected + " but it was "s + ch, ch)
+	UnexpectedChar(Error{ErrorCode::expectedChar,pos,ch,expected,{}}.message(), ch)
 {}
 
 EmptyObjectName::EmptyObjectName(Position pos):
-	UnexpectedChar(posToStr(pos) + " empty object name"s, '"')
+	UnexpectedChar(Error{ErrorCode::emptyObjectName,pos,'"',0,{}}.message(), '"')
 {
 
 }
 
+LoneSurrogate::LoneSurrogate(Position pos, char ch):
+	UnexpectedChar(Error{ErrorCode::loneSurrogate,pos,ch,0,{}}.message(), ch)
+{}
+
+#ifdef DIE_JSON_EXCEPTIONS
+void raise(Error const & error)
+{
+	switch(error.code) {
+		case ErrorCode::expectedChar: throw ExpectedChar(error.pos,error.expectedChar,error.offendingChar);
+		case ErrorCode::emptyObjectName: throw EmptyObjectName(error.pos);
+		case ErrorCode::loneSurrogate: throw LoneSurrogate(error.pos,error.offendingChar);
+		case ErrorCode::unexpectedObjectClosing: throw UnexpectedObjectClosing(error.pos);
+		case ErrorCode::unexpectedArrayClosing: throw UnexpectedArrayClosing(error.pos);
+		default: throw UnexpectedChar(error.pos,error.offendingChar);
+	}
+}
+#endif
+
 } /* namespace json */
 } /* namespace die */
@@ -4,6 +4,7 @@
 #include <stdexcept>
 #include <string>
 #include "JsonParserObjects.h"
+#include "JsonParserError.h"
 
 namespace die {
 namespace json {
@@ -31,6 +32,12 @@ public:
 	EmptyObjectName(Position pos);
 };
 
+// a \u escape with half of a surrogate pair. ch is the char where the other half was expected
+class LoneSurrogate: public UnexpectedChar {
+public:
+	LoneSurrogate(Position pos, char ch);
+};
+
 class UnexpectedObjectClosing: public UnexpectedChar {
 public:
 	UnexpectedObjectClosing(Position pos): UnexpectedChar(pos,'}') {}
@@ -41,6 +48,11 @@ public:
 	UnexpectedArrayClosing(Position pos): UnexpectedChar(pos,']') {}
 };
 
+#ifdef DIE_JSON_EXCEPTIONS
+// throws the exception class matching the error code
+[[noreturn]] void raise(Error const & error);
+#endif
+
 } /* namespace json */
 } /* namespace die */
 
@@ -0,0 +1,122 @@
+#include "JsonParserFile.h"
+#include "JsonParserError.h"
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace die {
+namespace json {
+
+namespace {
+	void fail(std::error_code & ec, std::error_code error, [[maybe_unused]] std::string const & what)
+	{
+		ec = error;
+#ifdef DIE_JSON_EXCEPTIONS
+		throw std::system_error(error,what);
+#endif
+	}
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(std::string const & path):
+	mapped(nullptr),
+	mappedSize(0),
+	file(INVALID_HANDLE_VALUE),
+	mapping(nullptr)
+{
+	file = CreateFileA(path.c_str(),GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_FLAG_SEQUENTIAL_SCAN,nullptr);
+	if( file == INVALID_HANDLE_VALUE ) {
+		fail(ec,std::error_code(GetLastError(),std::system_category()),"cannot open " + path);
+		return;
+	}
+
+	LARGE_INTEGER size;
+	if( ! GetFileSizeEx(file,&size) ) {
+		auto error = GetLastError();
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+		fail(ec,std::error_code(error,std::system_category()),"cannot stat " + path);
+		return;
+	}
+	mappedSize = std::size_t(size.QuadPart);
+	if( mappedSize == 0 ) return;	// empty files cannot be mapped
+
+	mapping = CreateFileMappingA(file,nullptr,PAGE_READONLY,0,0,nullptr);
+	if( mapping ) {
+		mapped = static_cast<char const *>(MapViewOfFile(mapping,FILE_MAP_READ,0,0,0));
+	}
+	if( ! mapped ) {
+		auto error = GetLastError();
+		if( mapping ) CloseHandle(mapping);
+		CloseHandle(file);
+		mapping = nullptr;
+		file = INVALID_HANDLE_VALUE;
+		mappedSize = 0;
+		fail(ec,std::error_code(error,std::system_category()),"cannot map " + path);
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	if( mapped ) UnmapViewOfFile(mapped);
+	if( mapping ) CloseHandle(mapping);
+	if( file != INVALID_HANDLE_VALUE ) CloseHandle(file);
+}
+
+#else
+
+MappedFile::MappedFile(std::string const & path):
+	mapped(nullptr),
+	mappedSize(0)
+{
+	auto fd = ::open(path.c_str(),O_RDONLY);
+	if( fd < 0 ) {
+		fail(ec,std::error_code(errno,std::generic_category()),"cannot open " + path);
+		return;
+	}
+
+	struct stat st;
+	if( ::fstat(fd,&st) != 0 ) {
+		auto error = errno;
+		::close(fd);
+		fail(ec,std::error_code(error,std::generic_category()),"cannot stat " + path);
+		return;
+	}
+	mappedSize = std::size_t(st.st_size);
+	if( mappedSize == 0 ) {	// empty files cannot be mapped
+		::close(fd);
+		return;
+	}
+
+	auto addr = ::mmap(nullptr,mappedSize,PROT_READ,MAP_PRIVATE,fd,0);
+	auto error = errno;
+	::close(fd);	// the mapping keeps the file alive
+	if( addr == MAP_FAILED ) {
+		mappedSize = 0;
+		fail(ec,std::error_code(error,std::generic_category()),"cannot map " + path);
+		return;
+	}
+
+	::madvise(addr,mappedSize,MADV_SEQUENTIAL);
+	mapped = static_cast<char const *>(addr);
+}
+
+MappedFile::~MappedFile()
+{
+	if( mapped ) ::munmap(const_cast<char *>(mapped),mappedSize);
+}
+
+#endif
+
+} /* namespace json */
+} /* namespace die */
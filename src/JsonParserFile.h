@@ -0,0 +1,36 @@
+#ifndef JSONPARSERFILE_H_DIE_JSON_2026_10_17
+#define JSONPARSERFILE_H_DIE_JSON_2026_10_17
+
+#include <string>
+#include <cstddef>
+#include <system_error>
+
+namespace die {
+namespace json {
+
+// read-only memory mapping of a whole file, advised for sequential access
+// throws std::system_error if the file cannot be opened or mapped
+// with exceptions disabled the file is left empty and error() tells why
+class MappedFile {
+	char const * mapped;
+	std::size_t mappedSize;
+	std::error_code ec;
+#ifdef _WIN32
+	void * file;
+	void * mapping;
+#endif
+public:
+	explicit MappedFile(std::string const & path);
+	~MappedFile();
+	MappedFile(MappedFile const &) = delete;
+	MappedFile & operator=(MappedFile const &) = delete;
+
+	char const * data() const { return mapped; }
+	std::size_t size() const { return mappedSize; }
+	std::error_code error() const { return ec; }
+};
+
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONPARSERFILE_H_ */
@@ -0,0 +1,171 @@
+#include "JsonParserGrammar.h"
+#include <climits>
+#include <cassert>
+#include <string>
+#include <type_traits>
+
+namespace {
+	static std::string const S = " \t\n\r";
+
+	// node names in the same order of grammar::State
+	static char const * const stateNames[] = {
+		"start", "startObject",
+		"stringValue", "stringEscape", "unicodeChar-xxxx", "unicodeChar-xxx", "unicodeChar-xx", "unicodeChar-x",
+		"startValue", "endValue",
+		"negativeNumber", "startFractionalNumber", "numberValue", "numberE", "exponentialNumber",
+		"nullValue-ull", "nullValue-ll", "nullValue-l",
+		"trueValue-rue", "trueValue-ue", "trueValue-e",
+		"falseValue-alse", "falseValue-lse", "falseValue-se", "falseValue-e",
+		"endAggregate",
+	};
+}
+
+namespace die {
+namespace json {
+namespace grammar {
+
+namespace {
+	template<typename C>
+	using Transition = automata::ActionTransition<C,Action>;
+	using Automata = automata::FiniteAutomata<automata::Range<char>,Transition<automata::Range<char>>>;
+
+	CompiledAutomata buildAutomaton()
+	{
+		Automata parserAut;
+		for( auto name : stateNames ) {
+			parserAut.getNode(name);
+		}
+		automata::RangeSetter<char,Transition> rs(parserAut);
+
+		// start
+		rs.setTrans("start",S,"start");
+		parserAut.setTrans("start",'{',"startObject").output = Action::startObject;
+		parserAut.setTrans("start",'[',"startValue").output = Action::startArray;
+
+		// startObject
+		rs.setTrans("startObject",S,"startObject");
+		parserAut.setTrans("startObject",'}',"endAggregate").output = Action::endObject; // empty object
+		parserAut.setTrans("startObject",'"',"stringValue").output = Action::startObjectName;
+
+		// stringValue - everything but the quote and the backslash is part of the string
+		parserAut.setTrans("stringValue",{CHAR_MIN,'"'-1},"stringValue").output =
+		parserAut.setTrans("stringValue",{'"'+1,'\\'-1},"stringValue").output =
+		parserAut.setTrans("stringValue",{'\\'+1,CHAR_MAX},"stringValue").output = Action::addValue;
+		parserAut.setTrans("stringValue",'\\',"stringEscape").output = Action::startEscape;
+		parserAut.setTrans("stringValue",'"',"endValue").output = Action::endString;
+
+		// stringEscape and unicodeChar
+		rs.setTrans("stringEscape","/\\\"","stringValue",Action::addValue);
+		rs.setTrans("stringEscape","bfnrt","stringValue",Action::addEscaped);
+		parserAut.setTrans("stringEscape",'u',"unicodeChar-xxxx").output = Action::startUnicode;
+		static std::string const hex = "0-9a-fA-F";
+		rs.setTrans("unicodeChar-xxxx",hex,"unicodeChar-xxx",Action::addUnicode);
+		rs.setTrans("unicodeChar-xxx",hex,"unicodeChar-xx",Action::addUnicode);
+		rs.setTrans("unicodeChar-xx",hex,"unicodeChar-x",Action::addUnicode);
+		rs.setTrans("unicodeChar-x",hex,"stringValue",Action::endUnicode);
+
+		// startValue
+		rs.setTrans("startValue",S,"startValue");
+		parserAut.setTrans("startValue",'{',"startObject").output = Action::startObject;
+		parserAut.setTrans("startValue",'[',"startValue").output = Action::startArray;
+		parserAut.setTrans("startValue",']',"endAggregate").output = Action::endArray; // empty array
+		parserAut.setTrans("startValue",'"',"stringValue").output = Action::startString;
+		parserAut.setTrans("startValue",'-',"negativeNumber").output =
+		parserAut.setTrans("startValue",'0',"startFractionalNumber").output = Action::beginNumber;
+		rs.setTrans("startValue","1-9","numberValue",Action::beginNumber);
+		parserAut.setTrans("startValue",'n',"nullValue-ull").output = Action::newNull;
+		parserAut.setTrans("startValue",'t',"trueValue-rue").output =
+		parserAut.setTrans("startValue",'f',"falseValue-alse").output = Action::newBoolean;
+
+		// endValue
+		rs.setTrans("endValue",S,"endValue");
+		parserAut.setTrans("endValue",':',"startValue").output = Action::endObjectName;
+		parserAut.setTrans("endValue",',',"startValue").output = Action::nextValue;
+		parserAut.setTrans("endValue",'}',"endAggregate").output = Action::endObject;
+		parserAut.setTrans("endValue",']',"endAggregate").output = Action::endArray;
+
+		// negativeNumber
+		parserAut.setTrans("negativeNumber",'0',"startFractionalNumber").output = Action::addValue;
+		rs.setTrans("negativeNumber","1-9","numberValue",Action::startNumber);
+
+		// startFractionalNumber (or just zero)
+		rs.setTrans("startFractionalNumber",S,"endValue",Action::emitNumber);
+		parserAut.setTrans("startFractionalNumber",',',"startValue").output = Action::emitNumberAndClear;
+		parserAut.setTrans("startFractionalNumber",'.',"numberValue").output = Action::startDot;
+		parserAut.setTrans("startFractionalNumber",'}',"endAggregate").output = Action::emitNumberAndEndObject;
+		parserAut.setTrans("startFractionalNumber",']',"endAggregate").output = Action::emitNumberAndEndArray;
+
+		// numberValue
+		rs.setTrans("numberValue",S,"endValue",Action::emitNumber);
+		parserAut.setTrans("numberValue",',',"startValue").output = Action::emitNumberAndClear;
+		parserAut.setTrans("numberValue",'}',"endAggregate").output = Action::emitNumberAndEndObject;
+		parserAut.setTrans("numberValue",']',"endAggregate").output = Action::emitNumberAndEndArray;
+		rs.setTrans("numberValue","0-9","numberValue",Action::addValue);
+		parserAut.setTrans("numberValue",'.',"numberValue").output = Action::numberDot;
+		parserAut.setTrans("numberValue",'e',"numberE").output =
+		parserAut.setTrans("numberValue",'E',"numberE").output = Action::numberE;
+
+		// numberE
+		parserAut.setTrans("numberE",'+',"exponentialNumber").output =
+		parserAut.setTrans("numberE",'-',"exponentialNumber").output = Action::addValue;
+		rs.setTrans("numberE","0-9","numberValue",Action::addValue);
+		// exponentialNumber
+		rs.setTrans("exponentialNumber","0-9","numberValue",Action::addValue);
+
+		// null
+		parserAut.setTrans("nullValue-ull",'u',"nullValue-ll").output =
+		parserAut.setTrans("nullValue-ll",'l',"nullValue-l").output = Action::addValue;
+		parserAut.setTrans("nullValue-l",'l',"endValue").output = Action::addAndEmitKeyword;
+		// true
+		parserAut.setTrans("trueValue-rue",'r',"trueValue-ue").output =
+		parserAut.setTrans("trueValue-ue",'u',"trueValue-e").output = Action::addValue;
+		parserAut.setTrans("trueValue-e",'e',"endValue").output = Action::addAndEmitKeyword;
+		// false
+		parserAut.setTrans("falseValue-alse",'a',"falseValue-lse").output =
+		parserAut.setTrans("falseValue-lse",'l',"falseValue-se").output =
+		parserAut.setTrans("falseValue-se",'s',"falseValue-e").output = Action::addValue;
+		parserAut.setTrans("falseValue-e",'e',"endValue").output = Action::addAndEmitKeyword;
+
+		// endAggregate
+		rs.setTrans("endAggregate",S,"endAggregate");
+		parserAut.setTrans("endAggregate",'}',"endAggregate").output = Action::endObject;
+		parserAut.setTrans("endAggregate",']',"endAggregate").output = Action::endArray;
+		parserAut.setTrans("endAggregate",',',"startValue").output = Action::nextAggregate;
+
+		parserAut.setStart("start");
+		parserAut.getNode("start").final = true;
+		parserAut.getNode("endAggregate").final = true;
+
+		auto compiled = parserAut.compile();
+		assert(compiled.size() == std::extent<decltype(stateNames)>::value);
+		assert(compiled.startState() == CompiledAutomata::StateId(State::start));
+		return compiled;
+	}
+}
+
+CompiledAutomata const & automaton()
+{
+	static CompiledAutomata const compiled = buildAutomaton();
+	return compiled;
+}
+
+char const * stateName(State state)
+{
+	return stateNames[std::size_t(state)];
+}
+
+std::bitset<256> acceptedChars(State state)
+{
+	std::bitset<256> accepted;
+	auto const & parserAut = automaton();
+	for( unsigned ch = 0; ch < CompiledAutomata::symbols; ++ch ) {
+		if( parserAut.transit(CompiledAutomata::StateId(state),ch).next != CompiledAutomata::noState() ) {
+			accepted.set(ch);
+		}
+	}
+	return accepted;
+}
+
+} /* namespace grammar */
+} /* namespace json */
+} /* namespace die */
@@ -0,0 +1,245 @@
+#ifndef JSONPARSERGRAMMAR_H_DIE_JSON_2026_10_17
+#define JSONPARSERGRAMMAR_H_DIE_JSON_2026_10_17
+
+#include <bitset>
+#include <cstdint>
+#include "automata/automata.h"
+
+namespace die {
+namespace json {
+
+// automaton runs the compiled table; switched runs a hand written switch over the states of the same grammar
+// that does the actions in place and takes digits, keywords and whitespace whole
+// indexed builds a structural index ahead and runs the switch of switched from stop to stop
+enum class Engine { automaton, switched, indexed, };
+
+namespace grammar {
+
+// outputs of the automaton. they are interpreted by BasicParser::doAction()
+enum class Action : std::uint8_t {
+	none,
+	startObject, endObject, startArray, endArray,
+	startObjectName, startString, endString,
+	addValue, startEscape, addEscaped, startUnicode, addUnicode, endUnicode,
+	beginNumber, startNumber, startDot, numberDot, numberE,
+	emitNumber, emitNumberAndClear, emitNumberAndEndObject, emitNumberAndEndArray,
+	newNull, newBoolean, addAndEmitKeyword,
+	endObjectName, nextValue, nextAggregate,
+};
+
+using CompiledAutomata = automata::CompiledAutomata<Action>;
+
+// states of the grammar. the automaton creates its nodes in this order, so they double as compiled state ids
+enum class State : CompiledAutomata::StateId {
+	start, startObject,
+	stringValue, stringEscape, unicodeChar_xxxx, unicodeChar_xxx, unicodeChar_xx, unicodeChar_x,
+	startValue, endValue,
+	negativeNumber, startFractionalNumber, numberValue, numberE, exponentialNumber,
+	nullValue_ull, nullValue_ll, nullValue_l,
+	trueValue_rue, trueValue_ue, trueValue_e,
+	falseValue_alse, falseValue_lse, falseValue_se, falseValue_e,
+	endAggregate,
+	none = CompiledAutomata::noState(),
+};
+
+struct Step {
+	State next;
+	Action action;
+};
+
+inline bool isSpace(char ch) { return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r'; }
+inline bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+inline bool isHex(char ch) { return isDigit(ch) || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F'); }
+
+// value of the 4 hex digits of a \u escape
+inline char32_t hexCode(char const * hex)
+{
+	char32_t code = 0;
+	for( int i = 0; i < 4; ++i ) {
+		auto ch = hex[i];
+		code = code * 16 + (isDigit(ch) ? ch - '0' : (ch | 0x20) - 'a' + 10);
+	}
+	return code;
+}
+
+// the char represented by a single char escape sequence or zero if it is not one
+inline char escapedChar(char ch)
+{
+	switch(ch) {
+		case '/': case '\\': case '"': return ch;
+		case 'b': return '\b';
+		case 'f': return '\f';
+		case 'n': return '\n';
+		case 'r': return '\r';
+		case 't': return '\t';
+	}
+	return 0;
+}
+
+// the grammar never changes, so it is built and compiled only once
+CompiledAutomata const & automaton();
+
+// the name of the automaton node of a state
+char const * stateName(State state);
+
+// the chars with a transition out of a state, read from its row of the table
+std::bitset<256> acceptedChars(State state);
+
+struct TableEngine {
+	CompiledAutomata const & parserAut;
+
+	TableEngine(): parserAut(automaton()) {}
+
+	bool final(State state) const { return parserAut.isFinal(CompiledAutomata::StateId(state)); }
+
+	Step transit(State state, char ch) const
+	{
+		auto const & transition = parserAut.transit(CompiledAutomata::StateId(state),ch);
+		return {State(transition.next),transition.output};
+	}
+};
+
+struct SwitchedEngine {
+	bool final(State state) const { return state == State::start || state == State::endAggregate; }
+
+	Step transit(State state, char ch) const
+	{
+		switch(state) {
+			case State::start:
+				if( isSpace(ch) ) return {State::start,Action::none};
+				if( ch == '{' ) return {State::startObject,Action::startObject};
+				if( ch == '[' ) return {State::startValue,Action::startArray};
+				break;
+			case State::startObject:
+				if( isSpace(ch) ) return {State::startObject,Action::none};
+				if( ch == '}' ) return {State::endAggregate,Action::endObject};
+				if( ch == '"' ) return {State::stringValue,Action::startObjectName};
+				break;
+			case State::stringValue:
+				if( ch == '"' ) return {State::endValue,Action::endString};
+				if( ch == '\\' ) return {State::stringEscape,Action::startEscape};
+				return {State::stringValue,Action::addValue};
+			case State::stringEscape:
+				switch(ch) {
+					case '/': case '\\': case '"': return {State::stringValue,Action::addValue};
+					case 'b': case 'f': case 'n': case 'r': case 't': return {State::stringValue,Action::addEscaped};
+					case 'u': return {State::unicodeChar_xxxx,Action::startUnicode};
+				}
+				break;
+			case State::unicodeChar_xxxx:
+				if( isHex(ch) ) return {State::unicodeChar_xxx,Action::addUnicode};
+				break;
+			case State::unicodeChar_xxx:
+				if( isHex(ch) ) return {State::unicodeChar_xx,Action::addUnicode};
+				break;
+			case State::unicodeChar_xx:
+				if( isHex(ch) ) return {State::unicodeChar_x,Action::addUnicode};
+				break;
+			case State::unicodeChar_x:
+				if( isHex(ch) ) return {State::stringValue,Action::endUnicode};
+				break;
+			case State::startValue:
+				if( isSpace(ch) ) return {State::startValue,Action::none};
+				switch(ch) {
+					case '{': return {State::startObject,Action::startObject};
+					case '[': return {State::startValue,Action::startArray};
+					case ']': return {State::endAggregate,Action::endArray};
+					case '"': return {State::stringValue,Action::startString};
+					case '-': return {State::negativeNumber,Action::beginNumber};
+					case '0': return {State::startFractionalNumber,Action::beginNumber};
+					case 'n': return {State::nullValue_ull,Action::newNull};
+					case 't': return {State::trueValue_rue,Action::newBoolean};
+					case 'f': return {State::falseValue_alse,Action::newBoolean};
+				}
+				if( isDigit(ch) ) return {State::numberValue,Action::beginNumber};
+				break;
+			case State::endValue:
+				if( isSpace(ch) ) return {State::endValue,Action::none};
+				switch(ch) {
+					case ':': return {State::startValue,Action::endObjectName};
+					case ',': return {State::startValue,Action::nextValue};
+					case '}': return {State::endAggregate,Action::endObject};
+					case ']': return {State::endAggregate,Action::endArray};
+				}
+				break;
+			case State::negativeNumber:
+				if( ch == '0' ) return {State::startFractionalNumber,Action::addValue};
+				if( isDigit(ch) ) return {State::numberValue,Action::startNumber};
+				break;
+			case State::startFractionalNumber:
+				if( isSpace(ch) ) return {State::endValue,Action::emitNumber};
+				switch(ch) {
+					case ',': return {State::startValue,Action::emitNumberAndClear};
+					case '.': return {State::numberValue,Action::startDot};
+					case '}': return {State::endAggregate,Action::emitNumberAndEndObject};
+					case ']': return {State::endAggregate,Action::emitNumberAndEndArray};
+				}
+				break;
+			case State::numberValue:
+				if( isDigit(ch) ) return {State::numberValue,Action::addValue};
+				if( isSpace(ch) ) return {State::endValue,Action::emitNumber};
+				switch(ch) {
+					case ',': return {State::startValue,Action::emitNumberAndClear};
+					case '}': return {State::endAggregate,Action::emitNumberAndEndObject};
+					case ']': return {State::endAggregate,Action::emitNumberAndEndArray};
+					case '.': return {State::numberValue,Action::numberDot};
+					case 'e': case 'E': return {State::numberE,Action::numberE};
+				}
+				break;
+			case State::numberE:
+				if( ch == '+' || ch == '-' ) return {State::exponentialNumber,Action::addValue};
+				if( isDigit(ch) ) return {State::numberValue,Action::addValue};
+				break;
+			case State::exponentialNumber:
+				if( isDigit(ch) ) return {State::numberValue,Action::addValue};
+				break;
+			case State::nullValue_ull:
+				if( ch == 'u' ) return {State::nullValue_ll,Action::addValue};
+				break;
+			case State::nullValue_ll:
+				if( ch == 'l' ) return {State::nullValue_l,Action::addValue};
+				break;
+			case State::nullValue_l:
+				if( ch == 'l' ) return {State::endValue,Action::addAndEmitKeyword};
+				break;
+			case State::trueValue_rue:
+				if( ch == 'r' ) return {State::trueValue_ue,Action::addValue};
+				break;
+			case State::trueValue_ue:
+				if( ch == 'u' ) return {State::trueValue_e,Action::addValue};
+				break;
+			case State::trueValue_e:
+				if( ch == 'e' ) return {State::endValue,Action::addAndEmitKeyword};
+				break;
+			case State::falseValue_alse:
+				if( ch == 'a' ) return {State::falseValue_lse,Action::addValue};
+				break;
+			case State::falseValue_lse:
+				if( ch == 'l' ) return {State::falseValue_se,Action::addValue};
+				break;
+			case State::falseValue_se:
+				if( ch == 's' ) return {State::falseValue_e,Action::addValue};
+				break;
+			case State::falseValue_e:
+				if( ch == 'e' ) return {State::endValue,Action::addAndEmitKeyword};
+				break;
+			case State::endAggregate:
+				if( isSpace(ch) ) return {State::endAggregate,Action::none};
+				switch(ch) {
+					case '}': return {State::endAggregate,Action::endObject};
+					case ']': return {State::endAggregate,Action::endArray};
+					case ',': return {State::startValue,Action::nextAggregate};
+				}
+				break;
+			case State::none:
+				break;
+		}
+		return {State::none,Action::none};
+	}
+};
+
+} /* namespace grammar */
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONPARSERGRAMMAR_H_ */
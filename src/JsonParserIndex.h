@@ -0,0 +1,209 @@
+#ifndef JSONPARSERINDEX_H_DIE_JSON_2026_10_17
+#define JSONPARSERINDEX_H_DIE_JSON_2026_10_17
+
+// stage 1 of the indexed engine: finds the structural chars of a window of input in 64 byte blocks
+// strings are told apart with bit tricks on whole blocks instead of a char by char state machine
+// the starts of numbers and keywords are stops too, so stage 2 never reads whitespace
+
+#include "JsonParserSimd.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
+
+namespace die {
+namespace json {
+namespace simd {
+
+// what a block leaves for the next one
+struct IndexCarry {
+	bool inString = false;
+	bool escaped = false;	// the first char of the next block follows an escaping backslash
+	bool separated = true;	// the last char was whitespace, an operator or a quote
+};
+
+struct BlockMasks {
+	std::uint64_t quotes = 0;
+	std::uint64_t backslashes = 0;
+	std::uint64_t operators = 0;	// { } [ ] : ,
+	std::uint64_t spaces = 0;
+};
+
+inline BlockMasks classify(char const * p)
+{
+	BlockMasks masks;
+#if defined(DIE_JSON_AVX2)
+	auto const quotes = _mm256_set1_epi8('"');
+	auto const backslashes = _mm256_set1_epi8('\\');
+	auto const colons = _mm256_set1_epi8(':');
+	auto const commas = _mm256_set1_epi8(',');
+	auto const openObjects = _mm256_set1_epi8('{');
+	auto const closeObjects = _mm256_set1_epi8('}');
+	auto const openArrays = _mm256_set1_epi8('[');
+	auto const closeArrays = _mm256_set1_epi8(']');
+	auto const blanks = _mm256_set1_epi8(' ');
+	auto const tabs = _mm256_set1_epi8('\t');
+	auto const newlines = _mm256_set1_epi8('\n');
+	auto const returns = _mm256_set1_epi8('\r');
+	for( int i = 0; i < 64; i += 32 ) {
+		auto block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p + i));
+		auto spaces = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(block,blanks),_mm256_cmpeq_epi8(block,tabs)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(block,newlines),_mm256_cmpeq_epi8(block,returns)));
+		masks.spaces |= std::uint64_t(unsigned(_mm256_movemask_epi8(spaces))) << i;
+		auto ops = _mm256_or_si256(
+			_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block,openObjects),_mm256_cmpeq_epi8(block,closeObjects)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(block,openArrays),_mm256_cmpeq_epi8(block,closeArrays))),
+			_mm256_or_si256(_mm256_cmpeq_epi8(block,colons),_mm256_cmpeq_epi8(block,commas)));
+		masks.quotes |= std::uint64_t(unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block,quotes)))) << i;
+		masks.backslashes |= std::uint64_t(unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block,backslashes)))) << i;
+		masks.operators |= std::uint64_t(unsigned(_mm256_movemask_epi8(ops))) << i;
+	}
+#elif defined(DIE_JSON_SSE2)
+	auto const quotes = _mm_set1_epi8('"');
+	auto const backslashes = _mm_set1_epi8('\\');
+	auto const colons = _mm_set1_epi8(':');
+	auto const commas = _mm_set1_epi8(',');
+	auto const openObjects = _mm_set1_epi8('{');
+	auto const closeObjects = _mm_set1_epi8('}');
+	auto const openArrays = _mm_set1_epi8('[');
+	auto const closeArrays = _mm_set1_epi8(']');
+	auto const blanks = _mm_set1_epi8(' ');
+	auto const tabs = _mm_set1_epi8('\t');
+	auto const newlines = _mm_set1_epi8('\n');
+	auto const returns = _mm_set1_epi8('\r');
+	for( int i = 0; i < 64; i += 16 ) {
+		auto block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p + i));
+		auto spaces = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(block,blanks),_mm_cmpeq_epi8(block,tabs)),
+			_mm_or_si128(_mm_cmpeq_epi8(block,newlines),_mm_cmpeq_epi8(block,returns)));
+		masks.spaces |= std::uint64_t(unsigned(_mm_movemask_epi8(spaces))) << i;
+		auto ops = _mm_or_si128(
+			_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block,openObjects),_mm_cmpeq_epi8(block,closeObjects)),
+				_mm_or_si128(_mm_cmpeq_epi8(block,openArrays),_mm_cmpeq_epi8(block,closeArrays))),
+			_mm_or_si128(_mm_cmpeq_epi8(block,colons),_mm_cmpeq_epi8(block,commas)));
+		masks.quotes |= std::uint64_t(unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(block,quotes)))) << i;
+		masks.backslashes |= std::uint64_t(unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(block,backslashes)))) << i;
+		masks.operators |= std::uint64_t(unsigned(_mm_movemask_epi8(ops))) << i;
+	}
+#else
+	for( int i = 0; i < 64; ++i ) {
+		auto bit = std::uint64_t(1) << i;
+		switch(p[i]) {
+			case '"': masks.quotes |= bit; break;
+			case '\\': masks.backslashes |= bit; break;
+			case '{': case '}': case '[': case ']': case ':': case ',': masks.operators |= bit; break;
+			case ' ': case '\t': case '\n': case '\r': masks.spaces |= bit; break;
+		}
+	}
+#endif
+	return masks;
+}
+
+inline unsigned lowestSet(std::uint64_t bits)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index,bits);
+	return index;
+#else
+	return __builtin_ctzll(bits);
+#endif
+}
+
+// bit i of the result is the parity of the bits 0..i
+inline std::uint64_t prefixXor(std::uint64_t bits)
+{
+#if defined(__PCLMUL__)
+	auto all = _mm_set1_epi8(char(0xFF));
+	auto result = _mm_clmulepi64_si128(_mm_set_epi64x(0,std::int64_t(bits)),all,0);
+	return std::uint64_t(_mm_cvtsi128_si64(result));
+#else
+	bits ^= bits << 1;
+	bits ^= bits << 2;
+	bits ^= bits << 4;
+	bits ^= bits << 8;
+	bits ^= bits << 16;
+	bits ^= bits << 32;
+	return bits;
+#endif
+}
+
+// the chars that follow an odd run of backslashes. carry tells whether the first char of the block does
+inline std::uint64_t escapedChars(std::uint64_t backslashes, bool & carry)
+{
+	std::uint64_t const evenBits = 0x5555555555555555ull;
+	std::uint64_t carryBit = carry;
+	backslashes &= ~carryBit;	// an escaped backslash does not start a run
+	auto followsEscape = backslashes << 1 | carryBit;
+	auto oddStarts = backslashes & ~evenBits & ~followsEscape;
+	// adding turns every run into a carry that lands right after it. runs starting on odd bits flip parity
+	auto evenStarts = oddStarts + backslashes;
+	carry = evenStarts < oddStarts;
+	auto invert = evenStarts << 1;
+	return (evenBits ^ invert) & followsEscape;
+}
+
+// writes to out the offsets from base of the chars in [p,end) that stage 2 stops at and returns the end of them:
+// { } [ ] : , outside strings, the quotes that open and close strings, the backslashes that start escapes
+// and any other char outside strings that follows whitespace, an operator or a quote, like the start of a number
+// so the first char after whitespace that is not whitespace is always a stop
+// out must have room for one offset per char plus indexSlack
+std::size_t const indexSlack = 4;
+
+inline std::uint32_t * buildIndex(char const * base, char const * p, char const * end, IndexCarry & carry, std::uint32_t * out)
+{
+	std::uint64_t const topBit = std::uint64_t(1) << 63;
+	while( p != end ) {
+		auto size = end - p;
+		char padded[64];
+		char const * block = p;
+		if( size < 64 ) {
+			std::memset(padded,' ',64);
+			std::memcpy(padded,p,size);
+			block = padded;
+		}
+		auto masks = classify(block);
+		bool escapeCarry = carry.escaped;
+		auto escaped = escapedChars(masks.backslashes,escapeCarry);
+		auto quotes = masks.quotes & ~escaped;
+		auto inString = prefixXor(quotes) ^ (carry.inString ? ~std::uint64_t(0) : 0);
+		auto separators = masks.spaces | masks.operators | quotes;
+		auto scalars = ~(separators | inString);
+		auto stops = (masks.operators & ~inString) | quotes | (masks.backslashes & ~escaped & inString);
+		stops |= scalars & (separators << 1 | std::uint64_t(carry.separated));
+
+		if( size < 64 ) {
+			stops &= (std::uint64_t(1) << size) - 1;
+			carry.escaped = (escaped >> size) & 1;
+			carry.inString = (inString >> (size - 1)) & 1;
+			carry.separated = (separators >> (size - 1)) & 1;
+		} else {
+			carry.escaped = escapeCarry;
+			carry.inString = inString >> 63;
+			carry.separated = separators >> 63;
+			size = 64;
+		}
+
+		// four offsets per round without a branch on each bit. the extra ones are overwritten by the next block
+		auto offset = std::uint32_t(p - base);
+		auto last = out + popCount(unsigned(stops)) + popCount(unsigned(stops >> 32));
+		for( ; out < last; out += 4 ) {
+			out[0] = offset + lowestSet(stops | topBit); stops &= stops - 1;
+			out[1] = offset + lowestSet(stops | topBit); stops &= stops - 1;
+			out[2] = offset + lowestSet(stops | topBit); stops &= stops - 1;
+			out[3] = offset + lowestSet(stops | topBit); stops &= stops - 1;
+		}
+		out = last;
+		p += size;
+	}
+	return out;
+}
+
+} /* namespace simd */
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONPARSERINDEX_H_ */
@@ -0,0 +1,122 @@
+#ifndef JSONPARSERNUMBERS_H_DIE_JSON_2026_10_17
+#define JSONPARSERNUMBERS_H_DIE_JSON_2026_10_17
+
+#include <string_view>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+// floating point from_chars is correctly rounded and Eisel-Lemire based in the recent standard libraries
+#if defined(__cpp_lib_to_chars) || (defined(_MSC_VER) && _MSC_VER >= 1924)
+#define DIE_JSON_FROM_CHARS
+#else
+#include <cstdlib>
+#include <string>
+#endif
+
+// conversion of number lexemes already validated by the grammar
+
+namespace die {
+namespace json {
+namespace numbers {
+
+// converts 8 ascii digits at once (SWAR)
+inline std::uint32_t eightDigits(char const * p)
+{
+	std::uint64_t val;
+	std::memcpy(&val,p,8);
+	val = (val & 0x0F0F0F0F0F0F0F0F) * 2561 >> 8;
+	val = (val & 0x00FF00FF00FF00FF) * 6553601 >> 16;
+	return std::uint32_t((val & 0x0000FFFF0000FFFF) * 42949672960001 >> 32);
+}
+
+// converts a run of decimal digits. false if it does not fit in 64 bits
+inline bool parseDigits(std::string_view digits, std::uint64_t & result)
+{
+	if( digits.size() > 20 || (digits.size() == 20 && digits > "18446744073709551615") ) return false;
+
+	auto p = digits.data();
+	auto end = p + digits.size();
+	std::uint64_t value = 0;
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+	for( ; end - p >= 8; p += 8 ) {
+		value = value * 100000000 + eightDigits(p);
+	}
+#endif
+	for( ; p != end; ++p ) {
+		value = value * 10 + (*p - '0');
+	}
+	result = value;
+	return true;
+}
+
+inline double parseDouble(std::string_view lexeme)
+{
+	static double const powersOf10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+
+	auto p = lexeme.data();
+	auto end = p + lexeme.size();
+	bool negative = *p == '-';
+	if( negative ) ++p;
+
+	// significant digits, with the decimal exponent adjusted by the fractional ones
+	std::uint64_t mantissa = 0;
+	int digits = 0;
+	int exp10 = 0;
+	auto addDigit = [&](char ch) {
+		if( digits == 0 && ch == '0' ) return;
+		if( ++digits <= 19 ) {
+			mantissa = mantissa * 10 + (ch - '0');
+		}
+	};
+	for( ; p != end && *p >= '0' && *p <= '9'; ++p ) {
+		addDigit(*p);
+	}
+	if( p != end && *p == '.' ) {
+		for( ++p; p != end && *p >= '0' && *p <= '9'; ++p ) {
+			addDigit(*p);
+			--exp10;
+		}
+	}
+	if( p != end ) {	// exponent
+		++p;
+		bool negativeExp = *p == '-';
+		if( *p == '-' || *p == '+' ) ++p;
+		int exp = 0;
+		for( ; p != end; ++p ) {
+			if( exp < 100000 ) exp = exp * 10 + (*p - '0');
+		}
+		exp10 += negativeExp ? -exp : exp;
+	}
+	if( digits > 19 ) exp10 += digits - 19;
+
+	// Clinger's fast path: both the mantissa and the power of ten are exact doubles
+	if( mantissa <= (std::uint64_t(1) << 53) && exp10 >= -22 && exp10 <= 22 ) {
+		double value = double(mantissa);
+		value = exp10 < 0 ? value / powersOf10[-exp10] : value * powersOf10[exp10];
+		return negative ? -value : value;
+	}
+
+	double value;
+#ifdef DIE_JSON_FROM_CHARS
+	auto result = std::from_chars(lexeme.data(),lexeme.data() + lexeme.size(),value);
+	if( result.ec == std::errc::result_out_of_range ) {
+		auto magnitude = exp10 + std::min(digits,19);
+		value = magnitude > 0 ? HUGE_VAL : 0.0;
+		return negative ? -value : value;
+	}
+#else
+	value = std::strtod(std::string(lexeme).c_str(),nullptr); // beware of the C locale
+#endif
+	return value;
+}
+
+} /* namespace numbers */
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONPARSERNUMBERS_H_ */
@@ -1,6 +1,7 @@
 #ifndef JSONPARSEROBJECTS_H_DIE_JSON_2015_06_06
 #define JSONPARSEROBJECTS_H_DIE_JSON_2015_06_06
 
+#include <cstddef>
 #include <ostream>
 
 namespace die {
@@ -10,8 +11,16 @@ struct Position {
 	int column,line;
 };
 
+// where a token is in the input, in bytes
+struct Span {
+	std::size_t offset,length;
+};
+
 enum class ValueType { null, string, number, boolean, };
 
+// what an event asks the parser to do next
+enum class Control { proceed, skip, stop, };
+
 } /* namespace json */
 } /* namespace die */
 
@@ -0,0 +1,310 @@
+#ifndef JSONPARSERSIMD_H_DIE_JSON_2026_10_17
+#define JSONPARSERSIMD_H_DIE_JSON_2026_10_17
+
+// vectorized scanners used by the parser fast paths and the writer
+// the instruction set is chosen at compile time. AVX2 and SSE2 have scalar fallbacks for the tails and other targets
+
+#if defined(__AVX2__)
+#define DIE_JSON_AVX2
+#define DIE_JSON_SSE2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DIE_JSON_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <cstddef>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace die {
+namespace json {
+namespace simd {
+
+inline unsigned firstSet(unsigned mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index,mask);
+	return index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+inline unsigned lastSet(unsigned mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse(&index,mask);
+	return index;
+#else
+	return 31 - __builtin_clz(mask);
+#endif
+}
+
+inline unsigned popCount(unsigned mask)
+{
+#ifdef _MSC_VER
+	return __popcnt(mask);
+#else
+	return __builtin_popcount(mask);
+#endif
+}
+
+// newlines found in a block of input
+struct Lines {
+	std::size_t count = 0;
+	char const * lastStart = nullptr; // the char after the last newline
+};
+
+// mask has one bit per newline relative to p
+inline void addLines(Lines & lines, char const * p, unsigned mask)
+{
+	if( mask ) {
+		lines.count += popCount(mask);
+		lines.lastStart = p + lastSet(mask) + 1;
+	}
+}
+
+inline Lines countLines(char const * p, char const * end)
+{
+	Lines lines;
+#ifdef DIE_JSON_AVX2
+	auto const newlines32 = _mm256_set1_epi8('\n');
+	for( ; end - p >= 32; p += 32 ) {
+		auto block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+		addLines(lines,p,_mm256_movemask_epi8(_mm256_cmpeq_epi8(block,newlines32)));
+	}
+#endif
+#ifdef DIE_JSON_SSE2
+	auto const newlines = _mm_set1_epi8('\n');
+	for( ; end - p >= 16; p += 16 ) {
+		auto block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+		addLines(lines,p,_mm_movemask_epi8(_mm_cmpeq_epi8(block,newlines)));
+	}
+#endif
+	for( ; p != end; ++p ) {
+		if( *p == '\n' ) {
+			++lines.count;
+			lines.lastStart = p + 1;
+		}
+	}
+	return lines;
+}
+
+// returns the first char in [p,end) that is not json whitespace, adding the skipped newlines to lines
+inline char const * skipWhitespace(char const * p, char const * end, Lines & lines)
+{
+#ifdef DIE_JSON_AVX2
+	auto const spaces32 = _mm256_set1_epi8(' ');
+	auto const tabs32 = _mm256_set1_epi8('\t');
+	auto const newlines32 = _mm256_set1_epi8('\n');
+	auto const returns32 = _mm256_set1_epi8('\r');
+	for( ; end - p >= 32; p += 32 ) {
+		auto block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+		auto nl = _mm256_cmpeq_epi8(block,newlines32);
+		auto ws = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(block,spaces32),_mm256_cmpeq_epi8(block,tabs32)),
+			_mm256_or_si256(nl,_mm256_cmpeq_epi8(block,returns32)));
+		unsigned nlMask = _mm256_movemask_epi8(nl);
+		unsigned other = ~unsigned(_mm256_movemask_epi8(ws));
+		if( other ) {
+			auto stop = firstSet(other);
+			addLines(lines,p,nlMask & ((1u << stop) - 1));
+			return p + stop;
+		}
+		addLines(lines,p,nlMask);
+	}
+#endif
+#ifdef DIE_JSON_SSE2
+	auto const spaces = _mm_set1_epi8(' ');
+	auto const tabs = _mm_set1_epi8('\t');
+	auto const newlines = _mm_set1_epi8('\n');
+	auto const returns = _mm_set1_epi8('\r');
+	for( ; end - p >= 16; p += 16 ) {
+		auto block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+		auto nl = _mm_cmpeq_epi8(block,newlines);
+		auto ws = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(block,spaces),_mm_cmpeq_epi8(block,tabs)),
+			_mm_or_si128(nl,_mm_cmpeq_epi8(block,returns)));
+		unsigned nlMask = _mm_movemask_epi8(nl);
+		unsigned other = ~unsigned(_mm_movemask_epi8(ws)) & 0xFFFF;
+		if( other ) {
+			auto stop = firstSet(other);
+			addLines(lines,p,nlMask & ((1u << stop) - 1));
+			return p + stop;
+		}
+		addLines(lines,p,nlMask);
+	}
+#endif
+	for( ; p != end; ++p ) {
+		switch(*p) {
+			case '\n':
+				++lines.count;
+				lines.lastStart = p + 1;
+				break;
+			case ' ': case '\t': case '\r':
+				break;
+			default:
+				return p;
+		}
+	}
+	return end;
+}
+
+// returns the first char in [p,end) that is not json whitespace
+inline char const * skipWhitespace(char const * p, char const * end)
+{
+#ifdef DIE_JSON_AVX2
+	auto const spaces32 = _mm256_set1_epi8(' ');
+	auto const tabs32 = _mm256_set1_epi8('\t');
+	auto const newlines32 = _mm256_set1_epi8('\n');
+	auto const returns32 = _mm256_set1_epi8('\r');
+	for( ; end - p >= 32; p += 32 ) {
+		auto block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+		auto ws = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(block,spaces32),_mm256_cmpeq_epi8(block,tabs32)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(block,newlines32),_mm256_cmpeq_epi8(block,returns32)));
+		unsigned other = ~unsigned(_mm256_movemask_epi8(ws));
+		if( other ) return p + firstSet(other);
+	}
+#endif
+#ifdef DIE_JSON_SSE2
+	auto const spaces = _mm_set1_epi8(' ');
+	auto const tabs = _mm_set1_epi8('\t');
+	auto const newlines = _mm_set1_epi8('\n');
+	auto const returns = _mm_set1_epi8('\r');
+	for( ; end - p >= 16; p += 16 ) {
+		auto block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+		auto ws = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(block,spaces),_mm_cmpeq_epi8(block,tabs)),
+			_mm_or_si128(_mm_cmpeq_epi8(block,newlines),_mm_cmpeq_epi8(block,returns)));
+		unsigned other = ~unsigned(_mm_movemask_epi8(ws)) & 0xFFFF;
+		if( other ) return p + firstSet(other);
+	}
+#endif
+	for( ; p != end; ++p ) {
+		switch(*p) {
+			case ' ': case '\t': case '\n': case '\r':
+				break;
+			default:
+				return p;
+		}
+	}
+	return end;
+}
+
+// returns the first quote or backslash in [p,end) or end if there is none
+inline char const * findQuoteOrEscape(char const * p, char const * end)
+{
+#ifdef DIE_JSON_AVX2
+	auto const quotes32 = _mm256_set1_epi8('"');
+	auto const escapes32 = _mm256_set1_epi8('\\');
+	for( ; end - p >= 32; p += 32 ) {
+		auto block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+		auto hits = _mm256_or_si256(_mm256_cmpeq_epi8(block,quotes32),_mm256_cmpeq_epi8(block,escapes32));
+		unsigned mask = _mm256_movemask_epi8(hits);
+		if( mask ) return p + firstSet(mask);
+	}
+#endif
+#ifdef DIE_JSON_SSE2
+	auto const quotes = _mm_set1_epi8('"');
+	auto const escapes = _mm_set1_epi8('\\');
+	for( ; end - p >= 16; p += 16 ) {
+		auto block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+		auto hits = _mm_or_si128(_mm_cmpeq_epi8(block,quotes),_mm_cmpeq_epi8(block,escapes));
+		unsigned mask = _mm_movemask_epi8(hits);
+		if( mask ) return p + firstSet(mask);
+	}
+#endif
+	for( ; p != end; ++p ) {
+		if( *p == '"' || *p == '\\' ) return p;
+	}
+	return end;
+}
+
+// returns the first char in [p,end) that a json string cannot hold as it is: quotes, backslashes and control chars
+inline char const * findEscapable(char const * p, char const * end)
+{
+#ifdef DIE_JSON_AVX2
+	auto const quotes32 = _mm256_set1_epi8('"');
+	auto const escapes32 = _mm256_set1_epi8('\\');
+	auto const controls32 = _mm256_set1_epi8(0x1F);
+	for( ; end - p >= 32; p += 32 ) {
+		auto block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+		auto hits = _mm256_or_si256(_mm256_cmpeq_epi8(block,quotes32),_mm256_cmpeq_epi8(block,escapes32));
+		hits = _mm256_or_si256(hits,_mm256_cmpeq_epi8(_mm256_max_epu8(block,controls32),controls32));
+		unsigned mask = _mm256_movemask_epi8(hits);
+		if( mask ) return p + firstSet(mask);
+	}
+#endif
+#ifdef DIE_JSON_SSE2
+	auto const quotes = _mm_set1_epi8('"');
+	auto const escapes = _mm_set1_epi8('\\');
+	auto const controls = _mm_set1_epi8(0x1F);
+	for( ; end - p >= 16; p += 16 ) {
+		auto block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+		auto hits = _mm_or_si128(_mm_cmpeq_epi8(block,quotes),_mm_cmpeq_epi8(block,escapes));
+		hits = _mm_or_si128(hits,_mm_cmpeq_epi8(_mm_max_epu8(block,controls),controls)); // unsigned block <= 0x1F
+		unsigned mask = _mm_movemask_epi8(hits);
+		if( mask ) return p + firstSet(mask);
+	}
+#endif
+	for( ; p != end; ++p ) {
+		if( *p == '"' || *p == '\\' || static_cast<unsigned char>(*p) < 0x20 ) return p;
+	}
+	return end;
+}
+
+// returns the first quote or bracket in [p,end) or end if there is none
+inline char const * findQuoteOrBracket(char const * p, char const * end)
+{
+#ifdef DIE_JSON_AVX2
+	auto const quotes32 = _mm256_set1_epi8('"');
+	auto const openObjects32 = _mm256_set1_epi8('{');
+	auto const closeObjects32 = _mm256_set1_epi8('}');
+	auto const openArrays32 = _mm256_set1_epi8('[');
+	auto const closeArrays32 = _mm256_set1_epi8(']');
+	for( ; end - p >= 32; p += 32 ) {
+		auto block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+		auto hits = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(block,openObjects32),_mm256_cmpeq_epi8(block,closeObjects32)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(block,openArrays32),_mm256_cmpeq_epi8(block,closeArrays32)));
+		hits = _mm256_or_si256(hits,_mm256_cmpeq_epi8(block,quotes32));
+		unsigned mask = _mm256_movemask_epi8(hits);
+		if( mask ) return p + firstSet(mask);
+	}
+#endif
+#ifdef DIE_JSON_SSE2
+	auto const quotes = _mm_set1_epi8('"');
+	auto const openObjects = _mm_set1_epi8('{');
+	auto const closeObjects = _mm_set1_epi8('}');
+	auto const openArrays = _mm_set1_epi8('[');
+	auto const closeArrays = _mm_set1_epi8(']');
+	for( ; end - p >= 16; p += 16 ) {
+		auto block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+		auto hits = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(block,openObjects),_mm_cmpeq_epi8(block,closeObjects)),
+			_mm_or_si128(_mm_cmpeq_epi8(block,openArrays),_mm_cmpeq_epi8(block,closeArrays)));
+		hits = _mm_or_si128(hits,_mm_cmpeq_epi8(block,quotes));
+		unsigned mask = _mm_movemask_epi8(hits);
+		if( mask ) return p + firstSet(mask);
+	}
+#endif
+	for( ; p != end; ++p ) {
+		switch(*p) {
+			case '"': case '{': case '}': case '[': case ']':
+				return p;
+		}
+	}
+	return end;
+}
+
+} /* namespace simd */
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONPARSERSIMD_H_ */
@@ -0,0 +1,39 @@
+#include "JsonParserStats.h"
+#include <numeric>
+
+namespace die {
+namespace json {
+
+std::uint64_t ParserStats::eventTotal() const
+{
+	return std::accumulate(events.begin(),events.end(),std::uint64_t(0));
+}
+
+} /* namespace json */
+} /* namespace die */
+
+std::ostream & operator<<(std::ostream & os, die::json::ParserStats const & stats)
+{
+	static char const * const eventNames[] = { "startObject", "endObject", "startArray", "endArray", "string", "number", "boolean", "null", };
+	using Ms = std::chrono::duration<double,std::milli>;
+
+	os << "bytes " << stats.bytes << '\n'
+		<< "events " << stats.eventTotal() << '\n'
+		<< "max depth " << stats.maxDepth << '\n'
+		<< "longest value " << stats.longestValue << '\n'
+		<< "allocations " << stats.allocations << '\n'
+		<< "parser ms " << Ms(stats.parserTime).count() << '\n'
+		<< "callback ms " << Ms(stats.callbackTime).count() << '\n';
+	for( std::size_t event = 0; event < stats.eventCount; ++event ) {
+		if( stats.events[event] ) {
+			os << "  " << eventNames[event] << ' ' << stats.events[event] << '\n';
+		}
+	}
+	os << "transitions\n";
+	for( std::size_t state = 0; state < stats.stateCount; ++state ) {
+		if( stats.transitions[state] ) {
+			os << "  " << die::json::grammar::stateName(die::json::grammar::State(state)) << ' ' << stats.transitions[state] << '\n';
+		}
+	}
+	return os;
+}
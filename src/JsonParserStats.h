@@ -0,0 +1,73 @@
+#ifndef JSONPARSERSTATS_H_DIE_JSON_2026_10_17
+#define JSONPARSERSTATS_H_DIE_JSON_2026_10_17
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include "JsonParserGrammar.h"
+
+namespace die {
+namespace json {
+
+// a parser keeps its statistics only in builds with DIE_JSON_STATS defined, for the whole program
+// otherwise every hook compiles to nothing and the stats stay zero
+#ifdef DIE_JSON_STATS
+bool const collectStats = true;
+#else
+bool const collectStats = false;
+#endif
+
+// where a parser spends its work. totals keep adding up over parses until clear()
+// they can be read from the events as well as after a parse
+struct ParserStats {
+	enum class Event { startObject, endObject, startArray, endArray, string, number, boolean, null, };
+	static std::size_t const eventCount = 8;
+	static std::size_t const stateCount = std::size_t(grammar::State::endAggregate) + 1;
+
+	std::uint64_t bytes = 0;	// consumed, fast paths included
+	std::array<std::uint64_t,eventCount> events{};	// delivered, by Event
+	std::array<std::uint64_t,stateCount> transitions{};	// by the state they leave. chars crossed by fast paths have none
+	std::size_t maxDepth = 0;	// of nested objects and arrays
+	std::size_t longestValue = 0;	// strings, numbers and names, in chars
+	std::uint64_t allocations = 0;	// made by the buffers of the parser: values, names, contexts and the index
+	std::chrono::nanoseconds parserTime{0};	// inside the parser, events excluded
+	std::chrono::nanoseconds callbackTime{0};	// inside the events
+
+	std::uint64_t eventTotal() const;
+	void clear() { *this = ParserStats(); }
+};
+
+// the allocations of the parser buffers go to the stats of the parser running on this thread, if any
+inline thread_local std::uint64_t * allocationCounter = nullptr;
+
+template<typename T>
+struct CountingAllocator {
+	using value_type = T;
+
+	CountingAllocator() = default;
+	template<typename U>
+	CountingAllocator(CountingAllocator<U> const &) {}
+
+	T * allocate(std::size_t n)
+	{
+		if( allocationCounter ) ++*allocationCounter;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T * p, std::size_t n) { std::allocator<T>().deallocate(p,n); }
+
+	template<typename U>
+	bool operator==(CountingAllocator<U> const &) const { return true; }
+	template<typename U>
+	bool operator!=(CountingAllocator<U> const &) const { return false; }
+};
+
+} /* namespace json */
+} /* namespace die */
+
+// totals, then the events and the transitions of each state that had any
+std::ostream & operator<<(std::ostream & os, die::json::ParserStats const & stats);
+
+#endif /* JSONPARSERSTATS_H_ */
@@ -0,0 +1,32 @@
+#include "JsonPath.h"
+
+namespace die {
+namespace json {
+
+std::string Path::pointer() const
+{
+	std::string result;
+	appendPointer(result);
+	return result;
+}
+
+void Path::appendPointer(std::string & out) const
+{
+	for( std::size_t i = 0; i < segments.size(); ++i ) {
+		out.push_back('/');
+		if( isIndex(i) ) {
+			out += std::to_string(index(i));
+			continue;
+		}
+		for( auto ch : key(i) ) {
+			switch(ch) {
+				case '~': out += "~0"; break;
+				case '/': out += "~1"; break;
+				default: out.push_back(ch);
+			}
+		}
+	}
+}
+
+} /* namespace json */
+} /* namespace die */
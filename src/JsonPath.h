@@ -0,0 +1,90 @@
+#ifndef JSONPATH_H_DIE_JSON_2026_10_17
+#define JSONPATH_H_DIE_JSON_2026_10_17
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "JsonKeySet.h"
+
+namespace die {
+namespace json {
+
+// location of the current event, kept up to date by the parser as it goes
+// there is one segment per open aggregate: the key inside an object or the element index inside an array
+// keys that stay around during the parse are viewed in place. the others share a single buffer,
+// so moving around the document does not allocate once it has grown
+class Path {
+	struct Segment {
+		char const * keyData;	// null when the key is in the buffer
+		std::size_t keyOffset;
+		std::size_t keySize;
+		std::size_t index;
+		KeySet::KeyId keyId;
+		bool isIndex;
+	};
+	std::string keys;
+	std::vector<Segment> segments;
+public:
+	std::size_t depth() const { return segments.size(); }
+	bool empty() const { return segments.empty(); }
+
+	bool isIndex(std::size_t i) const { return segments[i].isIndex; }
+	// the key of an object segment. empty for array segments
+	std::string_view key(std::size_t i) const
+	{
+		auto const & segment = segments[i];
+		return std::string_view(segment.keyData ? segment.keyData : keys.data() + segment.keyOffset,segment.keySize);
+	}
+	// the registered id of the key or KeySet::unknown
+	KeySet::KeyId keyId(std::size_t i) const { return segments[i].keyId; }
+	// the element index of an array segment
+	std::size_t index(std::size_t i) const { return segments[i].index; }
+
+	// JSON Pointer (RFC 6901) rendering, with ~ and / escaped inside keys
+	std::string pointer() const;
+	void appendPointer(std::string & out) const;
+
+	// called by the parser
+
+	void clear()
+	{
+		keys.clear();
+		segments.clear();
+	}
+
+	void pushKey() { segments.push_back({nullptr,keys.size(),0,0,KeySet::unknown,false}); }
+	void pushIndex(std::size_t first = 0) { segments.push_back({nullptr,keys.size(),0,first,KeySet::unknown,true}); }
+
+	void pop()
+	{
+		if( ! segments.back().keyData ) {
+			keys.resize(segments.back().keyOffset);
+		}
+		segments.pop_back();
+	}
+
+	// stable keys outlive the parse and are not copied
+	void setKey(std::string_view key, KeySet::KeyId keyId, bool stable)
+	{
+		auto & segment = segments.back();
+		segment.keyId = keyId;
+		segment.keySize = key.size();
+		if( ! segment.keyData ) {
+			keys.resize(segment.keyOffset);
+		}
+		if( stable ) {
+			segment.keyData = key.data();
+		} else {
+			segment.keyData = nullptr;
+			keys.append(key);
+		}
+	}
+
+	void nextIndex() { ++segments.back().index; }
+};
+
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONPATH_H_ */
@@ -0,0 +1,96 @@
+#include "JsonPathFilter.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include "JsonParserError.h"
+
+namespace die {
+namespace json {
+
+namespace {
+
+std::size_t const npos = std::string::npos;
+
+// a bad pattern is a programming error. without exceptions it aborts
+[[noreturn]] void badPattern([[maybe_unused]] std::string const & what)
+{
+#ifdef DIE_JSON_EXCEPTIONS
+	throw std::invalid_argument(what);
+#else
+	std::abort();
+#endif
+}
+
+std::string unescapeSegment(std::string_view segment, std::string_view pattern)
+{
+	std::string result;
+	for( std::size_t i = 0; i < segment.size(); ++i ) {
+		if( segment[i] != '~' ) {
+			result.push_back(segment[i]);
+		} else if( i + 1 < segment.size() && (segment[i+1] == '0' || segment[i+1] == '1') ) {
+			result.push_back(segment[++i] == '0' ? '~' : '/');
+		} else {
+			badPattern("bad escape in path pattern " + std::string(pattern));
+		}
+	}
+	return result;
+}
+
+std::size_t arrayIndex(std::string const & key)
+{
+	if( key.empty() || key.size() > 18 || ! std::all_of(key.begin(),key.end(),[](char ch) { return ch >= '0' && ch <= '9'; }) ) return npos;
+	if( key.size() > 1 && key[0] == '0' ) return npos;
+	return std::stoull(key);
+}
+
+}
+
+PathFilter::PathFilter(std::initializer_list<std::string_view> patterns)
+{
+	for( auto pattern : patterns ) {
+		add(pattern);
+	}
+}
+
+PathFilter & PathFilter::add(std::string_view pattern)
+{
+	if( ! pattern.empty() && pattern[0] != '/' ) badPattern("path pattern must start with / " + std::string(pattern));
+
+	std::vector<Segment> segments;
+	std::size_t start = 1;
+	while( start <= pattern.size() ) {
+		auto slash = std::min(pattern.find('/',start),pattern.size());
+		auto segment = pattern.substr(start,slash - start);
+		if( segment == "*" ) {
+			segments.push_back({std::string(),npos,true});
+		} else {
+			auto key = unescapeSegment(segment,pattern);
+			auto index = arrayIndex(key);
+			segments.push_back({std::move(key),index,false});
+		}
+		start = slash + 1;
+	}
+	patterns.push_back(std::move(segments));
+	return *this;
+}
+
+PathFilter::Match PathFilter::match(Path const & path) const
+{
+	auto result = Match::none;
+	for( auto const & pattern : patterns ) {
+		auto common = std::min(pattern.size(),path.depth());
+		std::size_t i = 0;
+		for( ; i < common; ++i ) {
+			auto const & segment = pattern[i];
+			if( segment.any ) continue;
+			if( path.isIndex(i) ? segment.index != path.index(i) : segment.key != path.key(i) ) break;
+		}
+		if( i < common ) continue;
+		if( pattern.size() <= path.depth() ) return Match::full;
+		result = Match::prefix;
+	}
+	return result;
+}
+
+} /* namespace json */
+} /* namespace die */
@@ -0,0 +1,41 @@
+#ifndef JSONPATHFILTER_H_DIE_JSON_2026_10_17
+#define JSONPATHFILTER_H_DIE_JSON_2026_10_17
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "JsonPath.h"
+
+namespace die {
+namespace json {
+
+// the paths a client subscribes to, written as JSON Pointers where a * segment matches any key or index
+// e.g. /events/*/user/id. the empty pointer subscribes to the whole document
+class PathFilter {
+public:
+	enum class Match { none, prefix, full, };
+
+	PathFilter() = default;
+	PathFilter(std::initializer_list<std::string_view> patterns);
+
+	// throws std::invalid_argument if the pattern is not a JSON Pointer. aborts when exceptions are disabled
+	PathFilter & add(std::string_view pattern);
+	bool empty() const { return patterns.empty(); }
+
+	// full when the path is at or below a pattern, prefix when a pattern is still below it
+	Match match(Path const & path) const;
+private:
+	struct Segment {
+		std::string key;
+		std::size_t index; // npos when the key is not an array index
+		bool any;
+	};
+	std::vector<std::vector<Segment>> patterns;
+};
+
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONPATHFILTER_H_ */
@@ -0,0 +1,69 @@
+#include "JsonReader.h"
+
+namespace die {
+namespace json {
+
+Reader::Token const Reader::endToken = {Reader::Kind::end,std::string_view(),std::string_view(),Span{0,0}};
+
+Reader::Reader():
+	Reader(std::string_view())
+{
+}
+
+Reader::Reader(std::string_view text)
+{
+	parser.getHandler().parser = &parser;
+	reset(text);
+}
+
+void Reader::reset(std::string_view text)
+{
+	auto & slot = parser.getHandler();
+	slot.input = text;
+	slot.count = 0;
+	current = 0;
+	started = false;
+	done = false;
+	control = Control::proceed;
+}
+
+Reader::Token const & Reader::next()
+{
+	auto & slot = parser.getHandler();
+	if( ++current < slot.count ) return slot.tokens[current];
+
+	slot.count = 0;
+	current = 0;
+	if( done ) return endToken;
+
+	done = true; // unless the parser pauses at another token
+	auto input = slot.input;
+	if( started ) {
+		auto offset = parser.stopOffset();
+		parser.resume(input.data() + offset,input.size() - offset,control);
+	} else {
+		started = true;
+		parser.parse(input.data(),input.size());
+	}
+	control = Control::proceed;
+	if( ! parser.paused() || parser.error() ) {
+		slot.count = 0;
+		return endToken;
+	}
+	done = false;
+	return slot.tokens[0];
+}
+
+void Reader::skip()
+{
+	auto & slot = parser.getHandler();
+	if( current + 1 < slot.count ) {
+		// the number before a closing bracket. what is left to skip is just that bracket
+		slot.count = current + 1;
+		return;
+	}
+	control = Control::skip;
+}
+
+} /* namespace json */
+} /* namespace die */
@@ -0,0 +1,95 @@
+#ifndef JSONREADER_H_DIE_JSON_2026_10_17
+#define JSONREADER_H_DIE_JSON_2026_10_17
+
+#include <string>
+#include <string_view>
+#include "JsonBasicParser.h"
+
+namespace die {
+namespace json {
+
+// pull interface over BasicParser: next() runs the parser until its next event and hands it back as a token
+// the parser pauses right after the char that completed the token, so nothing is buffered ahead
+// with Engine::indexed the structural index of the current window is kept from one token to the next
+// the text is parsed in place and has to outlive the reader. token views are valid until the next call to next()
+class Reader {
+public:
+	enum class Kind { end, startObject, endObject, startArray, endArray, string, number, boolean, null, };
+
+	struct Token {
+		Kind kind;
+		std::string_view key;	// the name passed to the event: of the value in an object, of the array holding it, empty at the root
+		std::string_view value;	// string contents, the number as written, true, false or null. empty for the others
+		Span span;	// the token in the text: a bracket, a string with its quotes, a number or a keyword
+	};
+private:
+	// a char ends two events at most, like the number and the bracket of 1]
+	struct Slot: BaseHandler {
+		BasicParser<Slot> * parser = nullptr;
+		std::string_view input;
+		std::string key; // the first token of a char keeps a copy of a key that is not in the input
+		Token tokens[2];
+		int count = 0;
+
+		void add(Kind kind, std::string_view name, std::string_view value = std::string_view())
+		{
+			if( count == 0 && ! name.empty() && ! inInput(name) ) {
+				key.assign(name.data(),name.size());
+				name = key;
+			}
+			tokens[count++] = Token{kind,name,value,parser->currentSpan()};
+			parser->pause();
+		}
+
+		bool inInput(std::string_view str) const
+		{
+			auto p = reinterpret_cast<std::uintptr_t>(str.data());
+			auto begin = reinterpret_cast<std::uintptr_t>(input.data());
+			return p >= begin && p < begin + input.size();
+		}
+
+		void onStartObject(std::string_view name) { add(Kind::startObject,name); }
+		void onEndObject(std::string_view name) { add(Kind::endObject,name); }
+		void onStartArray(std::string_view name) { add(Kind::startArray,name); }
+		void onEndArray(std::string_view name) { add(Kind::endArray,name); }
+		void onString(std::string_view name, std::string_view value) { add(Kind::string,name,value); }
+		void onNumber(std::string_view name, std::string_view value) { add(Kind::number,name,value); }
+		void onBool(std::string_view name, bool value) { add(Kind::boolean,name,value ? "true" : "false"); }
+		void onNull(std::string_view name) { add(Kind::null,name,"null"); }
+	};
+
+	BasicParser<Slot> parser;
+	int current;	// the token of the slot last returned
+	bool started;
+	bool done;
+	Control control;	// asked by skip() for the token last returned
+	static Token const endToken;
+public:
+	Reader();
+	explicit Reader(std::string_view text);
+	Reader(Reader const &) = delete;
+	Reader & operator=(Reader const &) = delete;
+
+	// starts over with another text
+	void reset(std::string_view text);
+
+	Reader & engine(Engine engineType) { parser.engine(engineType); return *this; }
+	// syntax errors are thrown from next() by default. otherwise next() returns an end token and error() is set
+	Reader & throwErrors(bool throwing) { parser.throwErrors(throwing); return *this; }
+	Error const & error() const { return parser.error(); }
+
+	// the end token comes once the document is over and keeps coming after that
+	Token const & next();
+
+	// skips what the last token opened or, after the other tokens, the rest of the innermost open object or array
+	// the skipped part is only matched for brackets and strings and its end token is not returned
+	void skip();
+
+	// byte offset right after the char that completed the last token
+	std::size_t offset() const { return parser.stopOffset(); }
+};
+
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONREADER_H_ */
@@ -0,0 +1,241 @@
+#include "JsonWriter.h"
+#include "JsonParserNumbers.h"
+#include "JsonParserSimd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#ifndef DIE_JSON_FROM_CHARS
+#include <cstdlib>
+#endif
+
+namespace die {
+namespace json {
+
+Writer::Writer():
+	sink(nullptr),
+	blockSize(0),
+	indentSize(0),
+	rootDone(false)
+{
+}
+
+Writer::Writer(std::ostream & os, std::size_t blockSize):
+	sink(&os),
+	blockSize(blockSize),
+	indentSize(0),
+	rootDone(false)
+{
+	buffer.reserve(blockSize + 256);
+}
+
+Writer::Writer(Writer && other):
+	buffer(std::move(other.buffer)),
+	sink(other.sink),
+	blockSize(other.blockSize),
+	indentSize(other.indentSize),
+	levels(std::move(other.levels)),
+	rootDone(other.rootDone)
+{
+	other.sink = nullptr;
+}
+
+Writer::~Writer()
+{
+	flush();
+}
+
+void Writer::onStartObject(std::string_view name)
+{
+	prefix(name);
+	buffer.push_back('{');
+	levels.push_back({true,true});
+}
+
+void Writer::onEndObject(std::string_view)
+{
+	close('}');
+}
+
+void Writer::onStartArray(std::string_view name)
+{
+	prefix(name);
+	buffer.push_back('[');
+	levels.push_back({false,true});
+}
+
+void Writer::onEndArray(std::string_view)
+{
+	close(']');
+}
+
+void Writer::onString(std::string_view name, std::string_view value)
+{
+	prefix(name);
+	writeString(value);
+	written();
+}
+
+void Writer::onNumber(std::string_view name, std::string_view value)
+{
+	prefix(name);
+	buffer.append(value);
+	written();
+}
+
+void Writer::onNumber(std::string_view name, double value)
+{
+	if( ! std::isfinite(value) ) {
+		onNull(name);
+		return;
+	}
+	prefix(name);
+	char text[32];
+#ifdef DIE_JSON_FROM_CHARS
+	auto end = std::to_chars(text,text + sizeof(text),value).ptr;
+#else
+	// the fewest digits that read back the same. beware of the C locale
+	int size = 0;
+	for( int precision = 15; precision <= 17; ++precision ) {
+		size = std::snprintf(text,sizeof(text),"%.*g",precision,value);
+		if( std::strtod(text,nullptr) == value ) break;
+	}
+	auto end = text + size;
+#endif
+	buffer.append(text,end);
+	// integral doubles keep a fraction, so they read back as doubles
+	if( std::none_of(text,end,[](char ch) { return ch == '.' || ch == 'e' || ch == 'E'; }) ) {
+		buffer.append(".0");
+	}
+	written();
+}
+
+void Writer::onNumber(std::string_view name, std::int64_t value)
+{
+	prefix(name);
+	char text[24];
+	buffer.append(text,std::to_chars(text,text + sizeof(text),value).ptr);
+	written();
+}
+
+void Writer::onNumber(std::string_view name, std::uint64_t value)
+{
+	prefix(name);
+	char text[24];
+	buffer.append(text,std::to_chars(text,text + sizeof(text),value).ptr);
+	written();
+}
+
+void Writer::onBool(std::string_view name, bool value)
+{
+	prefix(name);
+	buffer.append(value ? "true" : "false");
+	written();
+}
+
+void Writer::onNull(std::string_view name)
+{
+	prefix(name);
+	buffer.append("null");
+	written();
+}
+
+void Writer::flush()
+{
+	if( sink && ! buffer.empty() ) {
+		sink->rdbuf()->sputn(buffer.data(),buffer.size());
+		buffer.clear();
+	}
+}
+
+void Writer::clear()
+{
+	buffer.clear();
+	levels.clear();
+	rootDone = false;
+}
+
+// separator, line break and key of a new value
+void Writer::prefix(std::string_view name)
+{
+	if( levels.empty() ) {
+		if( rootDone ) {
+			buffer.push_back('\n');
+			rootDone = false;
+		}
+		return;
+	}
+	auto & level = levels.back();
+	if( ! level.empty ) {
+		buffer.push_back(',');
+	}
+	level.empty = false;
+	if( indentSize ) {
+		newline(levels.size());
+	}
+	if( level.object ) {
+		writeString(name);
+		buffer.append(indentSize ? ": " : ":");
+	}
+}
+
+void Writer::close(char closer)
+{
+	if( levels.empty() ) return;
+	bool empty = levels.back().empty;
+	levels.pop_back();
+	if( indentSize && ! empty ) {
+		newline(levels.size());
+	}
+	buffer.push_back(closer);
+	written();
+}
+
+void Writer::newline(std::size_t depth)
+{
+	buffer.push_back('\n');
+	buffer.append(depth * indentSize,' ');
+}
+
+// runs of plain chars are copied whole
+void Writer::writeString(std::string_view str)
+{
+	static char const hex[] = "0123456789abcdef";
+	buffer.push_back('"');
+	auto p = str.data();
+	auto end = p + str.size();
+	for(;;) {
+		auto q = simd::findEscapable(p,end);
+		buffer.append(p,q);
+		if( q == end ) break;
+		auto ch = *q;
+		buffer.push_back('\\');
+		switch(ch) {
+			case '"': case '\\': buffer.push_back(ch); break;
+			case '\b': buffer.push_back('b'); break;
+			case '\f': buffer.push_back('f'); break;
+			case '\n': buffer.push_back('n'); break;
+			case '\r': buffer.push_back('r'); break;
+			case '\t': buffer.push_back('t'); break;
+			default:
+				buffer.append("u00");
+				buffer.push_back(hex[ch >> 4]);
+				buffer.push_back(hex[ch & 0xF]);
+		}
+		p = q + 1;
+	}
+	buffer.push_back('"');
+}
+
+// ends a value. the stream gets whole blocks
+void Writer::written()
+{
+	if( levels.empty() ) {
+		rootDone = true;
+	}
+	if( sink && buffer.size() >= blockSize ) {
+		flush();
+	}
+}
+
+} /* namespace json */
+} /* namespace die */
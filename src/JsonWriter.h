@@ -0,0 +1,81 @@
+#ifndef JSONWRITER_H_DIE_JSON_2026_10_17
+#define JSONWRITER_H_DIE_JSON_2026_10_17
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace die {
+namespace json {
+
+// writes JSON text through events that mirror the ones of the parser handlers, so BasicParser<Writer> re-serializes
+// names become keys inside objects and are ignored elsewhere. a root after a finished one starts a new line
+// the text stays in a buffer that grows as needed or, with a stream, goes to the stream in blocks of blockSize
+class Writer {
+	struct Level {
+		bool object;
+		bool empty;
+	};
+
+	std::string buffer;
+	std::ostream * sink;
+	std::size_t blockSize;
+	int indentSize;
+	std::vector<Level> levels;
+	bool rootDone;
+
+	void prefix(std::string_view name);
+	void close(char closer);
+	void newline(std::size_t depth);
+	void writeString(std::string_view str);
+	void written();
+public:
+	Writer();
+	explicit Writer(std::ostream & os, std::size_t blockSize = 1 << 16);
+	// a moved writer leaves the stream to the new one
+	Writer(Writer && other);
+	Writer & operator=(Writer const &) = delete;
+	// flushes what is left
+	~Writer();
+
+	// pretty prints with spaces per level. zero, the default, writes compact text
+	Writer & indent(int spaces) { indentSize = spaces; return *this; }
+
+	void onStartObject(std::string_view name);
+	void onEndObject(std::string_view name);
+	void onStartArray(std::string_view name);
+	void onEndArray(std::string_view name);
+	void onString(std::string_view name, std::string_view value);
+	// the number as written in the input, which has to be a valid one
+	void onNumber(std::string_view name, std::string_view value);
+	// doubles are written in the shortest form that reads back the same. infinities and NaN become null
+	void onNumber(std::string_view name, double value);
+	void onNumber(std::string_view name, std::int64_t value);
+	void onNumber(std::string_view name, std::uint64_t value);
+	template<typename T>
+	std::enable_if_t<std::is_integral_v<T> && ! std::is_same_v<T,bool>> onNumber(std::string_view name, T value)
+	{
+		if constexpr( std::is_signed_v<T> ) {
+			onNumber(name,std::int64_t(value));
+		} else {
+			onNumber(name,std::uint64_t(value));
+		}
+	}
+	void onBool(std::string_view name, bool value);
+	void onNull(std::string_view name);
+
+	// the text not handed to the stream yet. all of it without a stream
+	std::string_view text() const { return buffer; }
+	// hands the buffered text to the stream
+	void flush();
+	// starts over, keeping the memory of the buffer
+	void clear();
+};
+
+} /* namespace json */
+} /* namespace die */
+
+#endif /* JSONWRITER_H_ */
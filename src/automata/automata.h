@@ -3,9 +3,12 @@
 
 #include <map>
 #include <unordered_map>
+#include <vector>
 #include <string>
 #include <utility>
 #include <functional>
+#include <limits>
+#include <cstdint>
 #include <cassert>
 
 // TODO this file really needs some documentation
@@ -33,6 +36,17 @@ struct MealyTransition {
 	}
 };
 
+// transition with a plain value as output instead of a callable
+// the client interprets the output (typically an enum) when running the compiled automaton
+template<typename C, typename A>
+struct ActionTransition {
+	Node<C,ActionTransition> * node;
+	typedef A output_type;
+	output_type output;
+	inline void operator()(C s) const {}
+	ActionTransition(): output() {}
+};
+
 template<typename C, typename TR>
 struct map_traits {
 	typedef std::map<C,TR> map_type;
@@ -64,7 +78,6 @@ public:
 		name(name),
 		final(false)
 	{
-		defaultTransition = [](C s) -> NodeRef { return nullptr; };
 	}
 
 	KeyType const & getName() const { return name; }
@@ -72,7 +85,7 @@ public:
 	ConstNodeRef transit(C s) const
 	{
 		auto t = map_traits<C,TR>::find(transitions,s);
-		if( t == transitions.end() ) return defaultTransition(s);
+		if( t == transitions.end() ) return defaultTransition ? defaultTransition(s) : nullptr;
 
 		auto & transition = map_traits<C,TR>::getValue(t);
 		transition(s);
@@ -87,6 +100,61 @@ public:
 	}
 };
 
+// maps a transition key to the inclusive range of byte symbols it covers
+template<typename C>
+struct symbol_traits {
+	static int first(C const & s) { return s; }
+	static int last(C const & s) { return s; }
+};
+
+// immutable table-driven automaton produced by FiniteAutomata::compile()
+// states are dense ids and every state owns a row of 256 entries indexed by the unsigned byte
+template<typename A, typename K = std::string>
+class CompiledAutomata {
+public:
+	using StateId = std::uint16_t;
+	using KeyType = K;
+	static constexpr StateId noState() { return std::numeric_limits<StateId>::max(); }
+
+	struct Entry {
+		StateId next;
+		A output;
+	};
+
+	static constexpr unsigned symbols = 256;
+private:
+	std::vector<Entry> table;
+	std::vector<KeyType> names;
+	std::vector<char> finals;
+	StateId start;
+public:
+	CompiledAutomata(std::vector<KeyType> names, StateId start):
+		table(names.size()*symbols,Entry{noState(),A()}),
+		names(std::move(names)),
+		finals(this->names.size(),false),
+		start(start)
+	{
+		assert(this->names.size() < noState());
+	}
+
+	Entry & entry(StateId state, unsigned char s) { return table[state*symbols + s]; }
+	void setFinal(StateId state, bool final) { finals[state] = final; }
+
+	Entry const & transit(StateId state, unsigned char s) const { return table[state*symbols + s]; }
+	bool isFinal(StateId state) const { return finals[state]; }
+	StateId startState() const { return start; }
+	std::size_t size() const { return names.size(); }
+	KeyType const & getName(StateId state) const { return names[state]; }
+
+	StateId stateId(KeyType const & name) const
+	{
+		for( std::size_t i = 0; i < names.size(); ++i ) {
+			if( names[i] == name ) return StateId(i);
+		}
+		return noState();
+	}
+};
+
 template<typename C = char, typename TR = BasicTransition<C>, typename N = Node<C,TR>>
 class FiniteAutomata {
 public:
@@ -96,11 +164,13 @@ public:
 	typedef N const * ConstNodeRef;
 private:
 	std::unordered_map<KeyType,N> nodes;
+	std::vector<KeyType> creationOrder;
 	N const * start;
 
 	N & createNode(KeyType const & name)
 	{
 		auto it = nodes.insert(std::make_pair(name,N(name)));
+		creationOrder.push_back(name);
 		return it.first->second;
 	}
 public:
@@ -186,6 +256,34 @@ public:
 	{
 		return output_iterator(start);
 	}
+
+	// builds the table-driven form. state ids follow node creation order
+	// only byte-sized symbols are supported and nodes must not have a defaultTransition
+	template<typename T = TR>
+	CompiledAutomata<typename T::output_type,KeyType> compile() const
+	{
+		using Compiled = CompiledAutomata<typename T::output_type,KeyType>;
+		auto idOf = [this](KeyType const & name) {
+			for( std::size_t i = 0; i < creationOrder.size(); ++i ) {
+				if( creationOrder[i] == name ) return typename Compiled::StateId(i);
+			}
+			return Compiled::noState();
+		};
+
+		Compiled result(creationOrder,idOf(start->getName()));
+		for( std::size_t id = 0; id < creationOrder.size(); ++id ) {
+			auto const & node = nodes.find(creationOrder[id])->second;
+			assert(! node.defaultTransition);
+			result.setFinal(id,node.final);
+			for( auto const & t : node.transitions ) {
+				auto next = idOf(t.second.node->getName());
+				for( int s = symbol_traits<C>::first(t.first); s <= symbol_traits<C>::last(t.first); ++s ) {
+					result.entry(id,static_cast<unsigned char>(s)) = {next,t.second.output};
+				}
+			}
+		}
+		return result;
+	}
 };
 
 
@@ -199,6 +297,12 @@ struct Range {
 
 template<typename C>
 bool operator<(Range<C> const & r1, Range<C> const & r2) { return r1.b < r2.a; }
+
+template<typename C>
+struct symbol_traits<Range<C>> {
+	static int first(Range<C> const & r) { return r.a; }
+	static int last(Range<C> const & r) { return r.b; }
+};
 //bool operator<(Range<C> const & r1, Range<C> const & r2) { return r1.a < r2.a && r1.b < r2.b; }
 //bool operator<(Range<C> const & r1, Range<C> const & r2) { return r1.a < r2.a && r2.b < r1.b; }
 